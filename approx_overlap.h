@@ -0,0 +1,176 @@
+#ifndef APPROX_OVERLAP_H
+#define APPROX_OVERLAP_H
+
+#include <stdint.h>
+#include <string.h>
+
+#include "overlap_matrix.h"
+
+// Reads up to APPROX_WORDS * 64 characters
+#define APPROX_WORDS 4
+// A, C, G, T and N, each matching itself; anything else never matches
+#define APPROX_SYMBOLS 5
+// Default shortest overlap allowed to carry errors
+#define APPROX_MIN_OVERLAP 20
+
+
+typedef struct approx_params{
+    int max_errors;    // mismatches, or edits when edits is set
+    int min_overlap;   // overlaps with errors must be at least this long
+    int edits;         // 1: Levenshtein (Myers), 0: Hamming
+} ApproxParams;
+
+
+// Per-read bit vectors, built once and shared by every pair the read is in
+typedef struct approx_pattern{
+    int len;
+    int words;
+    uint64_t peq[APPROX_SYMBOLS][APPROX_WORDS];   // bit i set where read[i] is that symbol
+    unsigned char sym[APPROX_WORDS * 64];
+} ApproxPattern;
+
+
+static inline int dna_symbol(const char c) {
+    switch (c) {
+        case 'A': case 'a': return 0;
+        case 'C': case 'c': return 1;
+        case 'G': case 'g': return 2;
+        case 'T': case 't': return 3;
+        case 'N': case 'n': return 4;
+        default: return APPROX_SYMBOLS;
+    }
+}
+
+
+static inline void approx_pattern_prepare(const char *__restrict__ read, const int len, ApproxPattern *__restrict__ p) {
+    memset(p, 0, sizeof(ApproxPattern));
+    p->len = len < APPROX_WORDS * 64 ? len : APPROX_WORDS * 64;
+    p->words = (p->len + 63) / 64;
+    for (int i = 0; i < p->len; i++) {
+        p->sym[i] = dna_symbol(read[i]);
+        if (p->sym[i] < APPROX_SYMBOLS)
+            p->peq[p->sym[i]][i >> 6] |= 1ULL << (i & 63);
+    }
+}
+
+
+// Overlap of length i with the given error count is kept if it is exact,
+// or if it is long enough to be trusted with errors
+static inline int approx_accept(const ApproxParams *__restrict__ params, const int i, const int errors) {
+    return errors == 0 || (errors <= params->max_errors && i >= params->min_overlap);
+}
+
+
+// Word w of the bit vector x shifted right by sh bits
+static inline uint64_t shifted_word(const uint64_t *__restrict__ x, const int words, const int w, const int sh) {
+    int q = w + (sh >> 6), r = sh & 63;
+    uint64_t lo = q < words ? x[q] : 0;
+    uint64_t hi = q + 1 < words ? x[q + 1] : 0;
+    return r ? (lo >> r) | (hi << (64 - r)) : lo;
+}
+
+
+// Longest prefix of b equal to a suffix of a up to max_errors mismatches.
+// Every candidate length is compared a word at a time: the matches are the
+// popcount of a's symbol vectors, shifted into place, ANDed with b's.
+static inline int approx_overlap_mismatches(const ApproxPattern *__restrict__ a, const ApproxPattern *__restrict__ b,
+    const ApproxParams *__restrict__ params) {
+
+    int max = a->len < b->len ? a->len : b->len;
+    for (int i = max; i > 0; i--) {
+        int sh = a->len - i, matches = 0;
+        for (int w = 0; w * 64 < i; w++) {
+            uint64_t keep = i - w * 64 >= 64 ? ~0ULL : (1ULL << (i - w * 64)) - 1;
+            for (int s = 0; s < APPROX_SYMBOLS; s++)
+                matches += __builtin_popcountll(shifted_word(a->peq[s], a->words, w, sh) & b->peq[s][w] & keep);
+        }
+        if (approx_accept(params, i, i - matches))
+            return i;
+    }
+    return 0;
+}
+
+
+// One 64-row block of Myers' bit-vector edit distance, in Hyyro's
+// formulation with the horizontal delta hin carried between blocks
+static inline int myers_block(uint64_t *__restrict__ pv, uint64_t *__restrict__ mv, uint64_t eq, const int hin) {
+    uint64_t hin_neg = hin < 0 ? 1 : 0;
+    uint64_t xv = eq | *mv;
+    eq |= hin_neg;
+    uint64_t xh = (((eq & *pv) + *pv) ^ *pv) | eq;
+    uint64_t ph = *mv | ~(xh | *pv);
+    uint64_t mh = *pv & xh;
+
+    int hout = 0;
+    if (ph >> 63) hout = 1;
+    if (mh >> 63) hout = -1;
+
+    ph = (ph << 1) | (uint64_t)(hin > 0);
+    mh = (mh << 1) | hin_neg;
+    *pv = mh | ~(xv | ph);
+    *mv = ph & xv;
+    return hout;
+}
+
+
+// Longest prefix of b within max_errors edits of a suffix of a. Runs Myers'
+// algorithm with b as the pattern over a as the text, starting anywhere in
+// a. After the last column, row i holds the edit distance between b[0, i)
+// and the best suffix of a.
+static inline int approx_overlap_edits(const ApproxPattern *__restrict__ a, const ApproxPattern *__restrict__ b,
+    const ApproxParams *__restrict__ params) {
+
+    uint64_t pv[APPROX_WORDS], mv[APPROX_WORDS];
+    for (int w = 0; w < b->words; w++) {
+        pv[w] = ~0ULL;
+        mv[w] = 0;
+    }
+
+    for (int j = 0; j < a->len; j++) {
+        int s = a->sym[j], hin = 0;
+        for (int w = 0; w < b->words; w++)
+            hin = myers_block(&pv[w], &mv[w], s < APPROX_SYMBOLS ? b->peq[s][w] : 0, hin);
+    }
+
+    int dist[APPROX_WORDS * 64 + 1];
+    dist[0] = 0;
+    for (int i = 1; i <= b->len; i++) {
+        int w = (i - 1) >> 6, bit = (i - 1) & 63;
+        dist[i] = dist[i - 1] + (int)(pv[w] >> bit & 1) - (int)(mv[w] >> bit & 1);
+    }
+
+    int max = a->len < b->len ? a->len : b->len;
+    for (int i = max; i > 0; i--) {
+        if (approx_accept(params, i, dist[i]))
+            return i;
+    }
+    return 0;
+}
+
+
+static inline int approx_overlap(const ApproxPattern *__restrict__ a, const ApproxPattern *__restrict__ b,
+    const ApproxParams *__restrict__ params) {
+    return params->edits ? approx_overlap_edits(a, b, params) : approx_overlap_mismatches(a, b, params);
+}
+
+
+// Error-tolerant replacement for read_set_build_overlaps: fills the same
+// matrix, so every engine consumes it unchanged
+static inline void read_set_build_overlaps_approx(ReadSet *__restrict__ rs, const ApproxParams *__restrict__ params) {
+    const int n = rs->n;
+    ApproxPattern *patterns = (ApproxPattern *)malloc((n ? n : 1) * sizeof(ApproxPattern));
+    rs->overlap = (int *)malloc((size_t)(n ? n : 1) * n * sizeof(int));
+
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < n; i++)
+        approx_pattern_prepare(rs->reads[i], rs->len[i], &patterns[i]);
+
+    #pragma omp parallel for schedule(dynamic, 16)
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++)
+            rs->overlap[(size_t)i * n + j] = i == j ? 0 : approx_overlap(&patterns[i], &patterns[j], params);
+    }
+    free(patterns);
+}
+
+#endif
@@ -0,0 +1,228 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include "overlap_matrix.h"
+#include "search_kernel.h"
+#include "beam_search.h"
+#include "window_opt.h"
+
+#define BATCH_EXACT_READS 16    // above this, beam search plus window re-optimization
+#define BATCH_SPLIT_READS 11    // above this, an exact solve is split into one task per first read
+#define BATCH_BEAM_WIDTH 64
+#define BATCH_WINDOW 12
+
+
+FILE *output;
+int exact_max = BATCH_EXACT_READS;
+
+
+typedef struct batch_instance{
+    const char *path;
+    ReadSet rs;
+    int best_len;
+    int shared_bound;   // live incumbent length the per-root searches prune with
+    int *order;
+    unsigned long long num_nodes;
+    struct timespec start;
+} BatchInstance;
+
+
+static double elapsed_since(const struct timespec *start) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - start->tv_sec) + (now.tv_nsec - start->tv_nsec) * 1e-9;
+}
+
+
+// Results go out as soon as an instance finishes, in completion order
+static void write_result(const BatchInstance *__restrict__ inst, const char *method) {
+    char *superstring = order_superstring(&inst->rs, inst->order);
+    double seconds = elapsed_since(&inst->start);
+
+    #pragma omp critical(batch_output)
+    {
+        fprintf(output, "%s\t%d\t%d\t%s\t%.3f\t%s\n", inst->path, inst->rs.n, inst->best_len,
+            method, seconds, superstring);
+        fflush(output);
+    }
+    free(superstring);
+}
+
+
+// One piece of a split exact solve: the subtree below a fixed first read.
+// The kernel keeps re-reading the shared bound, so improvements found by
+// the other pieces prune this one while it runs.
+static void solve_root(BatchInstance *__restrict__ inst, const int root) {
+    const ReadSet *rs = &inst->rs;
+    int *order = (int *)malloc(rs->n * sizeof(int));
+    int bound;
+
+    #pragma omp critical(batch_incumbent)
+    {
+        bound = inst->best_len;
+        memcpy(order, inst->order, rs->n * sizeof(int));
+    }
+
+    unsigned long long num_nodes = 0;
+    int len = solve_exact(rs->n, rs->len, rs->overlap, rs->n, bound, order, &num_nodes, root,
+        nullptr, &inst->shared_bound);
+
+    #pragma omp critical(batch_incumbent)
+    {
+        inst->num_nodes += num_nodes;
+        if (len < inst->best_len) {
+            inst->best_len = len;
+            memcpy(inst->order, order, rs->n * sizeof(int));
+        }
+    }
+    free(order);
+}
+
+
+static void solve_instance(const char *path) {
+    BatchInstance inst;
+    memset(&inst, 0, sizeof(inst));
+    inst.path = path;
+    clock_gettime(CLOCK_MONOTONIC, &inst.start);
+
+    if (!read_set_load(path, &inst.rs) || inst.rs.n == 0) {
+        #pragma omp critical(batch_output)
+        {
+            fprintf(output, "%s\t%d\t-1\terror\t0\t\n", path, inst.rs.n);
+            fflush(output);
+        }
+        read_set_free(&inst.rs);
+        return;
+    }
+
+    // Inside a task the helpers below split their rows and windows into
+    // tasks of the batch pool, so a large instance does not hold up the rest
+    ReadSet *rs = &inst.rs;
+    read_set_build_overlaps(rs);
+
+    BeamContext ctx;
+    beam_context_init(&ctx, rs);
+    inst.order = (int *)malloc(rs->n * sizeof(int));
+    inst.best_len = beam_search(&ctx, BATCH_BEAM_WIDTH, inst.order);
+    beam_context_free(&ctx);
+
+    if (rs->n > exact_max || rs->n > SEARCH_KERNEL_MAX_READS) {
+        inst.best_len = window_optimize(rs, inst.order, BATCH_WINDOW, NULL);
+        write_result(&inst, "approx");
+    }
+    else if (rs->n <= BATCH_SPLIT_READS) {
+        inst.best_len = solve_exact(rs->n, rs->len, rs->overlap, rs->n, inst.best_len, inst.order, &inst.num_nodes);
+        write_result(&inst, "exact");
+    }
+    else {
+        inst.shared_bound = inst.best_len;
+        #pragma omp taskgroup
+        {
+            for (int root = 0; root < rs->n; root++) {
+                #pragma omp task firstprivate(root) shared(inst)
+                solve_root(&inst, root);
+            }
+        }
+        write_result(&inst, "exact");
+    }
+
+    free(inst.order);
+    read_set_free(rs);
+}
+
+
+static int compare_paths(const void *a, const void *b) {
+    return strcmp(*(char *const *)a, *(char *const *)b);
+}
+
+
+// Instances are the regular files of a directory, or the lines of a manifest
+static char **list_instances(const char *source, int *count) {
+    int capacity = 64;
+    char **paths = (char **)malloc(capacity * sizeof(char *));
+    *count = 0;
+
+    struct stat st;
+    if (stat(source, &st) != 0) {
+        perror(source);
+        return paths;
+    }
+
+    if (S_ISDIR(st.st_mode)) {
+        DIR *dir = opendir(source);
+        struct dirent *entry;
+        while (dir && (entry = readdir(dir))) {
+            char path[4096];
+            snprintf(path, sizeof(path), "%s/%s", source, entry->d_name);
+            if (stat(path, &st) != 0 || !S_ISREG(st.st_mode)) continue;
+            if (*count == capacity) paths = (char **)realloc(paths, (capacity *= 2) * sizeof(char *));
+            paths[(*count)++] = strdup(path);
+        }
+        if (dir) closedir(dir);
+        qsort(paths, *count, sizeof(char *), compare_paths);
+    }
+    else {
+        FILE *fp = fopen(source, "r");
+        char line[4096];
+        while (fp && fgets(line, sizeof(line), fp)) {
+            line[strcspn(line, "\r\n")] = 0;
+            if (!line[0] || line[0] == '#') continue;
+            if (*count == capacity) paths = (char **)realloc(paths, (capacity *= 2) * sizeof(char *));
+            paths[(*count)++] = strdup(line);
+        }
+        if (fp) fclose(fp);
+    }
+    return paths;
+}
+
+
+int main(int argc, char *argv[]) {
+
+    const char *args[2];
+    int num_args = 0;
+    for (int a = 1; a < argc; a++) {
+        if (strncmp(argv[a], "--exact-max=", 12) == 0) exact_max = atoi(argv[a] + 12);
+        else if (num_args < 2) args[num_args++] = argv[a];
+    }
+
+    if (num_args != 2) {
+        fprintf(stderr, "Usage: %s <instance_dir|manifest> <output_file> [--exact-max=reads]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    int num_instances;
+    char **paths = list_instances(args[0], &num_instances);
+
+    output = fopen(args[1], "w");
+    if (!output) {
+        perror(args[1]);
+        return EXIT_FAILURE;
+    }
+    fprintf(output, "# path\treads\tlength\tmethod\tseconds\tsuperstring\n");
+
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    // One pool for the whole batch: every instance is a task, and the large
+    // exact ones spawn a task per first read into the same pool
+    #pragma omp parallel
+    #pragma omp single
+    {
+        for (int i = 0; i < num_instances; i++) {
+            #pragma omp task firstprivate(i)
+            solve_instance(paths[i]);
+        }
+    }
+
+    fclose(output);
+    printf("Solved %d instances in %.3fs\n", num_instances, elapsed_since(&start));
+
+    for (int i = 0; i < num_instances; i++)
+        free(paths[i]);
+    free(paths);
+    return 0;
+}
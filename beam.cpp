@@ -0,0 +1,91 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "overlap_matrix.h"
+#include "beam_search.h"
+#include "window_opt.h"
+#include "approx_overlap.h"
+
+#define DEFAULT_BEAM_WIDTH 64
+
+
+static double elapsed_since(const struct timespec *start) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - start->tv_sec) + (now.tv_nsec - start->tv_nsec) * 1e-9;
+}
+
+
+int main(int argc, char *argv[]) {
+
+    int beam_width = DEFAULT_BEAM_WIDTH, lds_discrepancies = -1, window = 0;
+    ApproxParams approx_params = {0, APPROX_MIN_OVERLAP, 1};
+    const char *filename = NULL;
+    for (int a = 1; a < argc; a++) {
+        if (strncmp(argv[a], "--lds=", 6) == 0) lds_discrepancies = atoi(argv[a] + 6);
+        else if (strncmp(argv[a], "--window=", 9) == 0) window = atoi(argv[a] + 9);
+        else if (strncmp(argv[a], "--errors=", 9) == 0) approx_params.max_errors = atoi(argv[a] + 9);
+        else if (strncmp(argv[a], "--min-overlap=", 14) == 0) approx_params.min_overlap = atoi(argv[a] + 14);
+        else if (strcmp(argv[a], "--hamming") == 0) approx_params.edits = 0;
+        else if (!filename) filename = argv[a];
+        else beam_width = atoi(argv[a]);
+    }
+
+    if (!filename || beam_width < 1) {
+        fprintf(stderr, "Usage: %s reads.txt [beam_width] [--lds=max_discrepancies] [--window=k]\n"
+            "    [--errors=k] [--min-overlap=len] [--hamming]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    ReadSet rs;
+    if (!read_set_load(filename, &rs)) return EXIT_FAILURE;
+    printf("\nNum reads: %d \n", rs.n);
+
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    if (approx_params.max_errors > 0) {
+        read_set_build_overlaps_approx(&rs, &approx_params);
+        printf("Overlap matrix, up to %d %s: %.3fs\n", approx_params.max_errors,
+            approx_params.edits ? "edits" : "mismatches", elapsed_since(&start));
+    }
+    else {
+        read_set_build_overlaps(&rs);
+        printf("Overlap matrix: %.3fs\n", elapsed_since(&start));
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    BeamContext ctx;
+    beam_context_init(&ctx, &rs);
+
+    int *order = (int *)malloc((rs.n ? rs.n : 1) * sizeof(int));
+    int best_len;
+    if (lds_discrepancies >= 0) {
+        best_len = lds_search(&ctx, lds_discrepancies, LDS_NODE_LIMIT, order);
+        printf("Limited discrepancy search, up to %d discrepancies: %.3fs\n", lds_discrepancies, elapsed_since(&start));
+    }
+    else {
+        best_len = beam_search(&ctx, beam_width, order);
+        printf("Beam search, width %d: %.3fs\n", beam_width, elapsed_since(&start));
+    }
+
+    // Polish the approximate ordering with exact window re-optimization
+    if (window > 1) {
+        int passes;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        int improved_len = window_optimize(&rs, order, window, &passes);
+        printf("Window re-optimization, k = %d: %d -> %d chars, %d passes, %.3fs\n",
+            window < WINDOW_MAX ? window : WINDOW_MAX, best_len, improved_len, passes, elapsed_since(&start));
+        best_len = improved_len;
+    }
+
+    char *best_result = order_superstring(&rs, order);
+    printf("Best superstring (%d chars):\n%s\n", best_len, best_result);
+
+    free(best_result);
+    free(order);
+    beam_context_free(&ctx);
+    read_set_free(&rs);
+    return 0;
+}
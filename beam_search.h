@@ -0,0 +1,307 @@
+#ifndef BEAM_SEARCH_H
+#define BEAM_SEARCH_H
+
+#include <stdint.h>
+#include <limits.h>
+
+#include "overlap_matrix.h"
+
+// Successors kept per read. Candidates are drawn from these lists, so a
+// step costs O(beam_width * BEAM_SUCCESSORS) instead of O(beam_width * n).
+#define BEAM_SUCCESSORS 8
+#define LDS_NODE_LIMIT 50000000LL
+
+
+typedef struct beam_context{
+    const ReadSet *rs;
+    int *succ;       // n * BEAM_SUCCESSORS best successors by overlap, -1 padded
+    int *lb_cost;    // len[j] - best incoming overlap of j, a lower bound on what j adds
+    int lb_total;    // sum of lb_cost over all reads
+    int words;       // 64-bit words in a used set
+    int *starts;     // all reads, best start first
+} BeamContext;
+
+
+typedef struct beam_candidate{
+    int score;    // prefix length plus lower bound on the remaining reads
+    int len;
+    int parent;   // slot in the previous beam
+    int read;
+} BeamCandidate;
+
+
+static inline int compare_candidates(const void *a, const void *b) {
+    const BeamCandidate *x = (const BeamCandidate *)a, *y = (const BeamCandidate *)b;
+    if (x->score != y->score) return x->score < y->score ? -1 : 1;
+    if (x->len != y->len) return x->len < y->len ? -1 : 1;
+    return x->read - y->read;
+}
+
+
+// Best BEAM_SUCCESSORS successors of read i, by overlap
+static inline void beam_successor_row(BeamContext *__restrict__ ctx, const int i) {
+    const ReadSet *rs = ctx->rs;
+    const int n = rs->n;
+    int *row = ctx->succ + (size_t)i * BEAM_SUCCESSORS;
+    int kept = 0;
+    for (int j = 0; j < n; j++) {
+        if (j == i) continue;
+        int ov = rs->overlap[(size_t)i * n + j];
+        if (kept == BEAM_SUCCESSORS && ov <= rs->overlap[(size_t)i * n + row[kept - 1]]) continue;
+
+        // insertion into the short sorted list
+        int pos = kept < BEAM_SUCCESSORS ? kept++ : kept - 1;
+        while (pos > 0 && rs->overlap[(size_t)i * n + row[pos - 1]] < ov) {
+            row[pos] = row[pos - 1];
+            --pos;
+        }
+        row[pos] = j;
+    }
+    for (int k = kept; k < BEAM_SUCCESSORS; k++)
+        row[k] = -1;
+}
+
+
+static inline void beam_context_init(BeamContext *__restrict__ ctx, const ReadSet *__restrict__ rs) {
+    const int n = rs->n;
+    ctx->rs = rs;
+    ctx->words = (n + 63) / 64;
+    ctx->succ = (int *)malloc((size_t)(n ? n : 1) * BEAM_SUCCESSORS * sizeof(int));
+    ctx->lb_cost = (int *)malloc((n ? n : 1) * sizeof(int));
+
+    for (int j = 0; j < n; j++)
+        ctx->lb_cost[j] = rs->len[j];
+
+    if (in_parallel_region()) {
+        #pragma omp taskloop grainsize(64)
+        for (int i = 0; i < n; i++)
+            beam_successor_row(ctx, i);
+    }
+    else {
+        #pragma omp parallel for schedule(static)
+        for (int i = 0; i < n; i++)
+            beam_successor_row(ctx, i);
+    }
+
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            int add = rs->len[j] - rs->overlap[(size_t)i * n + j];
+            if (i != j && add < ctx->lb_cost[j]) ctx->lb_cost[j] = add;
+        }
+    }
+    ctx->lb_total = 0;
+    for (int j = 0; j < n; j++)
+        ctx->lb_total += ctx->lb_cost[j];
+
+    // Reads with poor incoming overlaps make the best starts
+    BeamCandidate *rank = (BeamCandidate *)malloc((n > 0 ? n : 1) * sizeof(BeamCandidate));
+    for (int j = 0; j < n; j++)
+        rank[j] = (BeamCandidate){ctx->lb_total - ctx->lb_cost[j] + rs->len[j], rs->len[j], -1, j};
+    qsort(rank, n, sizeof(BeamCandidate), compare_candidates);
+    ctx->starts = (int *)malloc((size_t)(n ? n : 1) * sizeof(int));
+    for (int s = 0; s < n; s++)
+        ctx->starts[s] = rank[s].read;
+    free(rank);
+}
+
+
+static inline void beam_context_free(BeamContext *__restrict__ ctx) {
+    free(ctx->succ);
+    free(ctx->lb_cost);
+    free(ctx->starts);
+}
+
+
+// Unused successors of last, best overlap first. When all of last's good
+// successors are taken, the prefix effectively starts over, so the best
+// unused starts are offered instead.
+static inline int next_candidates(const BeamContext *__restrict__ ctx, const int last,
+    const uint64_t *__restrict__ used, int *__restrict__ out) {
+
+    int count = 0;
+    const int *row = ctx->succ + (size_t)last * BEAM_SUCCESSORS;
+    for (int k = 0; k < BEAM_SUCCESSORS && row[k] >= 0; k++) {
+        if (!(used[row[k] >> 6] >> (row[k] & 63) & 1))
+            out[count++] = row[k];
+    }
+    if (count) return count;
+
+    for (int s = 0; s < ctx->rs->n && count < BEAM_SUCCESSORS; s++) {
+        int j = ctx->starts[s];
+        if (!(used[j >> 6] >> (j & 63) & 1))
+            out[count++] = j;
+    }
+    return count;
+}
+
+
+// Beam search over partial orderings. Keeps the beam_width best prefixes at
+// every step, each expanded in parallel into at most BEAM_SUCCESSORS children.
+// *stop is checked between steps; a stopped search completes its best
+// prefix with the unused reads in index order.
+// Fills order with n reads and returns the superstring length.
+static inline int beam_search(const BeamContext *__restrict__ ctx, const int beam_width, int *__restrict__ order,
+    const volatile int *stop = nullptr) {
+    const ReadSet *rs = ctx->rs;
+    const int n = rs->n, words = ctx->words;
+    if (n == 0) return 0;
+
+    const int width = beam_width < n ? beam_width : n;
+    int *history_read = (int *)malloc((size_t)n * width * sizeof(int));
+    int *history_parent = (int *)malloc((size_t)n * width * sizeof(int));
+    uint64_t *used = (uint64_t *)calloc((size_t)width * words, sizeof(uint64_t));
+    uint64_t *next_used = (uint64_t *)calloc((size_t)width * words, sizeof(uint64_t));
+    int *beam_len = (int *)malloc(width * sizeof(int));
+    int *beam_rem = (int *)malloc(width * sizeof(int));
+    int *num_cand = (int *)malloc(width * sizeof(int));
+    BeamCandidate *cand = (BeamCandidate *)malloc((size_t)width * BEAM_SUCCESSORS * sizeof(BeamCandidate));
+
+    int size = width;
+    for (int s = 0; s < size; s++) {
+        int j = ctx->starts[s];
+        history_read[s] = j;
+        history_parent[s] = -1;
+        used[(size_t)s * words + (j >> 6)] |= 1ULL << (j & 63);
+        beam_len[s] = rs->len[j];
+        beam_rem[s] = ctx->lb_total - ctx->lb_cost[j];
+    }
+
+    int step = 1;
+    for (; step < n && !(stop && *stop); step++) {
+        const int *prev_read = history_read + (size_t)(step - 1) * width;
+
+        #pragma omp parallel for schedule(static)
+        for (int s = 0; s < size; s++) {
+            int children[BEAM_SUCCESSORS];
+            int last = prev_read[s];
+            num_cand[s] = next_candidates(ctx, last, used + (size_t)s * words, children);
+            for (int c = 0; c < num_cand[s]; c++) {
+                int j = children[c];
+                int len = beam_len[s] + rs->len[j] - rs->overlap[(size_t)last * n + j];
+                int rem = beam_rem[s] - ctx->lb_cost[j];
+                cand[s * BEAM_SUCCESSORS + c] = (BeamCandidate){len + rem, len, s, j};
+            }
+        }
+
+        int total = 0;
+        for (int s = 0; s < size; s++) {
+            memmove(cand + total, cand + s * BEAM_SUCCESSORS, num_cand[s] * sizeof(BeamCandidate));
+            total += num_cand[s];
+        }
+        qsort(cand, total, sizeof(BeamCandidate), compare_candidates);
+
+        int next_size = total < width ? total : width;
+        int *step_read = history_read + (size_t)step * width;
+        int *step_parent = history_parent + (size_t)step * width;
+        for (int s = 0; s < next_size; s++) {
+            const BeamCandidate *c = &cand[s];
+            memcpy(next_used + (size_t)s * words, used + (size_t)c->parent * words, words * sizeof(uint64_t));
+            next_used[(size_t)s * words + (c->read >> 6)] |= 1ULL << (c->read & 63);
+            step_read[s] = c->read;
+            step_parent[s] = c->parent;
+        }
+        // lengths are read from cand before the beam arrays are overwritten
+        for (int s = 0; s < next_size; s++) {
+            beam_len[s] = cand[s].len;
+            beam_rem[s] = cand[s].score - cand[s].len;
+        }
+
+        uint64_t *tmp = used; used = next_used; next_used = tmp;
+        size = next_size;
+    }
+
+    int best = 0;
+    for (int s = 1; s < size; s++)
+        if (beam_len[s] < beam_len[best]) best = s;
+    int best_len = beam_len[best];
+
+    const int placed = step;
+    for (int k = placed - 1, s = best; k >= 0; k--) {
+        order[k] = history_read[(size_t)k * width + s];
+        s = history_parent[(size_t)k * width + s];
+    }
+    if (placed < n) {
+        const uint64_t *best_used = used + (size_t)best * words;
+        for (int j = 0, k = placed; j < n; j++)
+            if (!(best_used[j >> 6] >> (j & 63) & 1)) order[k++] = j;
+        best_len = order_length(rs, order);
+    }
+
+    free(history_read); free(history_parent);
+    free(used); free(next_used);
+    free(beam_len); free(beam_rem); free(num_cand); free(cand);
+    return best_len;
+}
+
+
+typedef struct lds_search{
+    const BeamContext *ctx;
+    uint64_t *used;
+    int *path;
+    int *best_order;
+    int best_len;
+    long long nodes;
+    long long node_limit;
+} LdsSearch;
+
+
+static inline void lds_dfs(LdsSearch *__restrict__ s, const int depth, const int last,
+    const int curr_len, const int rem, const int discrepancies) {
+
+    const ReadSet *rs = s->ctx->rs;
+    if (++s->nodes > s->node_limit) return;
+
+    if (depth == rs->n) {
+        if (curr_len < s->best_len) {
+            s->best_len = curr_len;
+            memcpy(s->best_order, s->path, rs->n * sizeof(int));
+        }
+        return;
+    }
+    if (curr_len + rem >= s->best_len) return;  // lb_cost is admissible
+
+    int children[BEAM_SUCCESSORS];
+    int count = next_candidates(s->ctx, last, s->used, children);
+
+    // Following the heuristic is free, every other branch spends a discrepancy
+    for (int r = 0; r < count && (r == 0 || discrepancies > 0); r++) {
+        int j = children[r];
+        s->used[j >> 6] |= 1ULL << (j & 63);
+        s->path[depth] = j;
+        lds_dfs(s, depth + 1, j, curr_len + rs->len[j] - rs->overlap[(size_t)last * rs->n + j],
+            rem - s->ctx->lb_cost[j], discrepancies - (r > 0));
+        s->used[j >> 6] &= ~(1ULL << (j & 63));
+    }
+}
+
+
+// Limited discrepancy search around the successor-list heuristic, with
+// iterations allowing 0, 1, ..., max_discrepancies deviations. Stops early
+// after node_limit nodes. Fills order and returns the superstring length.
+static inline int lds_search(const BeamContext *__restrict__ ctx, const int max_discrepancies,
+    const long long node_limit, int *__restrict__ order) {
+
+    const ReadSet *rs = ctx->rs;
+    const int n = rs->n;
+    if (n == 0) return 0;
+
+    LdsSearch s = {ctx, (uint64_t *)calloc(ctx->words, sizeof(uint64_t)),
+        (int *)malloc(n * sizeof(int)), order, INT_MAX, 0, node_limit};
+
+    const int num_starts = n < BEAM_SUCCESSORS ? n : BEAM_SUCCESSORS;
+
+    for (int d = 0; d <= max_discrepancies && s.nodes < node_limit; d++) {
+        for (int r = 0; r < num_starts && (r == 0 || d > 0); r++) {
+            int j = ctx->starts[r];
+            s.used[j >> 6] |= 1ULL << (j & 63);
+            s.path[0] = j;
+            lds_dfs(&s, 1, j, rs->len[j], ctx->lb_total - ctx->lb_cost[j], d - (r > 0));
+            s.used[j >> 6] &= ~(1ULL << (j & 63));
+        }
+    }
+
+    free(s.used); free(s.path);
+    return s.best_len;
+}
+
+#endif
@@ -0,0 +1,755 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <omp.h>
+
+#include "overlap_matrix.h"
+#include "search_kernel.h"
+#include "beam_search.h"
+#include "window_opt.h"
+#include "incremental.h"
+
+#ifndef _OPENMP
+#error "daemon.cpp runs its worker pool on OpenMP, build with -fopenmp"
+#endif
+
+#define DAEMON_MAX_CLIENTS 64
+#define DAEMON_CACHE_ENTRIES 64
+#define DAEMON_MAX_SESSIONS 64
+#define DAEMON_EXACT_READS 16
+#define DAEMON_BEAM_WIDTH 64
+#define DAEMON_WINDOW 12
+#define DAEMON_POLL_MS 20
+
+// Protocol, one command per line:
+//
+//   SOLVE <id> [limit_ms=<ms>] [mode=auto|exact|approx]
+//   <read>
+//   ...
+//   END
+//   UPDATE <session> [limit_ms=<ms>] [mode=auto|exact|approx]
+//   +<read>
+//   -<read>
+//   ...
+//   END
+//   DROP <session>
+//   CANCEL <id>
+//   STATS
+//   QUIT
+//
+// Each SOLVE is answered, possibly out of order, with
+//
+//   RESULT <id> <optimal|approx|timeout|cancelled> <length> <nodes> <ms> <hit|miss|incr> <superstring>
+//
+// A timed out or cancelled solve reports the best ordering it reached, in
+// any phase: overlaps not yet computed count as zero.
+//
+// A session keeps its reads between UPDATEs: each one adds (+) and removes
+// (-) reads, then re-solves warm from the previous ordering ("incr"; "miss"
+// for a new session). Updates of a session run in the order their END
+// arrived, and a stopped one still applies its reads. DROP frees the
+// session; an UPDATE of it still being sent then fails with
+// "ERROR <session> session dropped".
+
+enum { MODE_AUTO, MODE_EXACT, MODE_APPROX };
+enum { STOP_NONE, STOP_CANCELLED, STOP_TIMEOUT };
+
+
+typedef struct daemon_client{
+    int in_fd, out_fd;
+    char *line;               // partial line read so far
+    int line_len, line_cap;
+    struct daemon_job *filling;   // SOLVE still receiving reads
+    int pending;              // jobs queued or running for this client
+    int closed;
+    pthread_mutex_t lock;
+} DaemonClient;
+
+
+typedef struct daemon_job{
+    char id[64];
+    DaemonClient *client;
+    char **reads;
+    int n, cap;
+    int mode;
+    long long limit_ms;
+    struct timespec start;
+    volatile int stop;
+    struct daemon_session *session;   // UPDATE and DROP only
+    char **removed;
+    int num_removed, removed_cap;
+    int drop;
+    unsigned long long seq;           // position among the session's updates
+    unsigned long long generation;    // session incarnation the job was opened on
+    struct daemon_job *next;
+} DaemonJob;
+
+
+typedef struct daemon_session{
+    char name[64];
+    IncrementalSet set;
+    unsigned long long next_seq, done_seq;
+    unsigned long long generation;   // tells a reused slot from the session it held
+    int valid;
+    int dropping;   // DROP queued, new UPDATEs of this name start afresh
+} DaemonSession;
+
+
+typedef struct cache_entry{
+    unsigned long long key;
+    ReadSet rs;
+    int refs;
+    unsigned long long last_used;
+    int valid;
+} CacheEntry;
+
+
+pthread_mutex_t queue_lock = PTHREAD_MUTEX_INITIALIZER;
+pthread_cond_t queue_cond = PTHREAD_COND_INITIALIZER;
+DaemonJob *queue_head = NULL, *queue_tail = NULL;
+DaemonJob **running;          // one slot per worker
+int num_queued = 0, num_running = 0, shutting_down = 0;
+unsigned long long jobs_done = 0;
+
+pthread_mutex_t cache_lock = PTHREAD_MUTEX_INITIALIZER;
+CacheEntry cache[DAEMON_CACHE_ENTRIES];
+unsigned long long cache_clock = 0, cache_hits = 0, cache_misses = 0;
+
+pthread_mutex_t session_lock = PTHREAD_MUTEX_INITIALIZER;
+pthread_cond_t session_turn = PTHREAD_COND_INITIALIZER;
+DaemonSession sessions[DAEMON_MAX_SESSIONS];
+unsigned long long session_generation = 0;
+
+
+static long long elapsed_ms(const struct timespec *start) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - start->tv_sec) * 1000LL + (now.tv_nsec - start->tv_nsec) / 1000000;
+}
+
+
+static void client_write(DaemonClient *__restrict__ c, const char *msg) {
+    pthread_mutex_lock(&c->lock);
+    size_t left = strlen(msg);
+    while (!c->closed && left > 0) {
+        ssize_t w = write(c->out_fd, msg, left);
+        if (w < 0 && errno == EINTR) continue;
+        if (w <= 0) break;
+        msg += w;
+        left -= w;
+    }
+    pthread_mutex_unlock(&c->lock);
+}
+
+
+static void client_free(DaemonClient *__restrict__ c) {
+    if (c->in_fd > 2) close(c->in_fd);
+    if (c->out_fd > 2 && c->out_fd != c->in_fd) close(c->out_fd);
+    pthread_mutex_destroy(&c->lock);
+    free(c->line);
+    free(c);
+}
+
+
+// A job no longer holds its client; the last one out frees a closed client
+static void client_release(DaemonClient *__restrict__ c) {
+    pthread_mutex_lock(&c->lock);
+    int last = --c->pending == 0 && c->closed;
+    pthread_mutex_unlock(&c->lock);
+    if (last) client_free(c);
+}
+
+
+static void job_free(DaemonJob *__restrict__ job) {
+    for (int i = 0; i < job->n; i++)
+        free(job->reads[i]);
+    for (int i = 0; i < job->num_removed; i++)
+        free(job->removed[i]);
+    free(job->reads);
+    free(job->removed);
+    free(job);
+}
+
+
+static unsigned long long hash_reads(char *const *reads, const int n) {
+    unsigned long long h = 1469598103934665603ULL;  // FNV-1a
+    for (int r = 0; r < n; r++) {
+        for (const char *c = reads[r]; ; c++) {
+            h = (h ^ (unsigned char)*c) * 1099511628211ULL;
+            if (!*c) break;
+        }
+    }
+    return h;
+}
+
+
+static int same_reads(const ReadSet *__restrict__ rs, char *const *reads, const int n) {
+    if (rs->n != n) return 0;
+    for (int i = 0; i < n; i++)
+        if (strcmp(rs->reads[i], reads[i]) != 0) return 0;
+    return 1;
+}
+
+
+// Cached read set with its overlap matrix, or NULL. The entry is pinned
+// until cache_release.
+static CacheEntry *cache_acquire(const unsigned long long key, char *const *reads, const int n) {
+    CacheEntry *found = NULL;
+    pthread_mutex_lock(&cache_lock);
+    for (int e = 0; e < DAEMON_CACHE_ENTRIES && !found; e++) {
+        if (cache[e].valid && cache[e].key == key && same_reads(&cache[e].rs, reads, n)) {
+            found = &cache[e];
+            found->refs++;
+            found->last_used = ++cache_clock;
+        }
+    }
+    if (found) cache_hits++;
+    else cache_misses++;
+    pthread_mutex_unlock(&cache_lock);
+    return found;
+}
+
+
+// Hands a freshly built read set to the cache, evicting the least recently
+// used unpinned entry. Returns the pinned entry, or NULL if all are pinned
+// and the caller keeps ownership.
+static CacheEntry *cache_insert(const unsigned long long key, ReadSet *__restrict__ rs) {
+    CacheEntry *slot = NULL;
+    pthread_mutex_lock(&cache_lock);
+    for (int e = 0; e < DAEMON_CACHE_ENTRIES; e++) {
+        if (cache[e].refs) continue;
+        if (!cache[e].valid) {
+            slot = &cache[e];
+            break;
+        }
+        if (!slot || cache[e].last_used < slot->last_used) slot = &cache[e];
+    }
+    if (slot) {
+        if (slot->valid) read_set_free(&slot->rs);
+        slot->key = key;
+        slot->rs = *rs;
+        slot->refs = 1;
+        slot->valid = 1;
+        slot->last_used = ++cache_clock;
+    }
+    pthread_mutex_unlock(&cache_lock);
+    return slot;
+}
+
+
+static void cache_release(CacheEntry *__restrict__ entry) {
+    pthread_mutex_lock(&cache_lock);
+    entry->refs--;
+    pthread_mutex_unlock(&cache_lock);
+}
+
+
+static void reply(DaemonJob *__restrict__ job, const char *status, const int len,
+    const unsigned long long nodes, const char *cache_state, const char *superstring) {
+
+    size_t size = strlen(superstring) + 256;
+    char *msg = (char *)malloc(size);
+    snprintf(msg, size, "RESULT %s %s %d %llu %lld %s %s\n", job->id, status, len, nodes,
+        elapsed_ms(&job->start), cache_state, superstring);
+    client_write(job->client, msg);
+    free(msg);
+}
+
+
+static void solve_job(DaemonJob *__restrict__ job) {
+    if (job->stop) {
+        reply(job, job->stop == STOP_CANCELLED ? "cancelled" : "timeout", -1, 0, "-", "");
+        return;
+    }
+    if (job->n == 0) {
+        reply(job, "optimal", 0, 0, "-", "");
+        return;
+    }
+
+    // Overlap matrices are reused across requests with the same reads
+    unsigned long long key = hash_reads(job->reads, job->n);
+    CacheEntry *entry = cache_acquire(key, job->reads, job->n);
+    const char *cache_state = entry ? "hit" : "miss";
+    ReadSet own;
+
+    if (!entry) {
+        memset(&own, 0, sizeof(own));
+        own.n = job->n;
+        own.reads = job->reads;
+        own.len = (int *)malloc(job->n * sizeof(int));
+        for (int i = 0; i < job->n; i++)
+            own.len[i] = strlen(job->reads[i]);
+        int complete = read_set_build_overlaps(&own, &job->stop);
+        job->reads = NULL;
+        job->n = 0;
+        // A matrix cut short by a stop is only good for this reply
+        if (complete) entry = cache_insert(key, &own);
+    }
+    const ReadSet *rs = entry ? &entry->rs : &own;
+
+    int *order = (int *)malloc(rs->n * sizeof(int));
+    BeamContext ctx;
+    beam_context_init(&ctx, rs);
+    int best_len = beam_search(&ctx, DAEMON_BEAM_WIDTH, order, &job->stop);
+    beam_context_free(&ctx);
+
+    // Every phase checks the stop flag, so a stopped job still replies
+    // with the best ordering reached
+    unsigned long long nodes = 0;
+    int exact = job->mode == MODE_EXACT ||
+        (job->mode == MODE_AUTO && rs->n <= DAEMON_EXACT_READS);
+
+    if (exact && rs->n <= SEARCH_KERNEL_MAX_READS)
+        best_len = solve_exact(rs->n, rs->len, rs->overlap, rs->n, best_len, order, &nodes, -1, &job->stop);
+    else
+        best_len = window_optimize(rs, order, DAEMON_WINDOW, NULL, &job->stop);
+
+    const char *status = job->stop == STOP_CANCELLED ? "cancelled" : job->stop == STOP_TIMEOUT ? "timeout" :
+        exact && rs->n <= SEARCH_KERNEL_MAX_READS ? "optimal" : "approx";
+
+    char *superstring = order_superstring(rs, order);
+    reply(job, status, best_len, nodes, cache_state, superstring);
+    free(superstring);
+    free(order);
+
+    if (entry) cache_release(entry);
+    else read_set_free(&own);
+}
+
+
+// Applies an UPDATE or DROP once the session's earlier updates are done.
+// Updates are queued in the order they were sent, so the one being waited
+// on is already running on another worker.
+static void update_job(DaemonJob *__restrict__ job) {
+    DaemonSession *session = job->session;
+    pthread_mutex_lock(&session_lock);
+    while (session->done_seq != job->seq)
+        pthread_cond_wait(&session_turn, &session_lock);
+    pthread_mutex_unlock(&session_lock);
+
+    IncrementalSet *set = &session->set;
+    if (job->drop) {
+        incremental_free(set);
+        char msg[128];
+        snprintf(msg, sizeof(msg), "DROPPED %s\n", job->id);
+        client_write(job->client, msg);
+    }
+    else {
+        const int cold = set->rs.n == 0;
+        incremental_remove(set, job->removed, job->num_removed);
+        incremental_add(set, job->reads, job->n);
+
+        unsigned long long nodes = 0;
+        int exact = job->mode == MODE_EXACT ||
+            (job->mode == MODE_AUTO && set->rs.n <= DAEMON_EXACT_READS);
+        int len = job->stop ? set->best_len :
+            incremental_solve(set, exact, DAEMON_WINDOW, cold, &nodes, &job->stop);
+
+        const char *status = job->stop == STOP_CANCELLED ? "cancelled" : job->stop == STOP_TIMEOUT ? "timeout" :
+            set->optimal ? "optimal" : "approx";
+        char *superstring = order_superstring(&set->rs, set->order);
+        reply(job, status, len, nodes, cold ? "miss" : "incr", superstring);
+        free(superstring);
+    }
+
+    // A DROP is the last turn of its session: later UPDATEs of the name
+    // opened a new one, and those still being sent fail at END
+    pthread_mutex_lock(&session_lock);
+    session->done_seq++;
+    if (job->drop) session->valid = 0;
+    pthread_cond_broadcast(&session_turn);
+    pthread_mutex_unlock(&session_lock);
+}
+
+
+// Live session of that name, or a new one; NULL when all slots are taken
+static DaemonSession *session_find(const char *name) {
+    DaemonSession *free_slot = NULL;
+    for (int k = 0; k < DAEMON_MAX_SESSIONS; k++) {
+        if (!sessions[k].valid) {
+            if (!free_slot) free_slot = &sessions[k];
+        }
+        else if (!sessions[k].dropping && strcmp(sessions[k].name, name) == 0) {
+            return &sessions[k];
+        }
+    }
+    if (free_slot) {
+        memset(free_slot, 0, sizeof(DaemonSession));
+        snprintf(free_slot->name, sizeof(free_slot->name), "%s", name);
+        incremental_init(&free_slot->set);
+        free_slot->generation = ++session_generation;
+        free_slot->valid = 1;
+    }
+    return free_slot;
+}
+
+
+static void worker_loop(const int slot) {
+    for (;;) {
+        pthread_mutex_lock(&queue_lock);
+        while (!queue_head && !shutting_down)
+            pthread_cond_wait(&queue_cond, &queue_lock);
+        if (!queue_head) {
+            pthread_mutex_unlock(&queue_lock);
+            return;
+        }
+        DaemonJob *job = queue_head;
+        queue_head = job->next;
+        if (!queue_head) queue_tail = NULL;
+        --num_queued;
+        ++num_running;
+        running[slot] = job;
+        pthread_mutex_unlock(&queue_lock);
+
+        if (job->session) update_job(job);
+        else solve_job(job);
+
+        pthread_mutex_lock(&queue_lock);
+        running[slot] = NULL;
+        --num_running;
+        ++jobs_done;
+        pthread_cond_broadcast(&queue_cond);
+        pthread_mutex_unlock(&queue_lock);
+
+        DaemonClient *c = job->client;
+        job_free(job);
+        client_release(c);
+    }
+}
+
+
+// Takes the next turn of the job's session. Turns are handed out when a job
+// is complete, so a worker never waits on an update still being sent.
+// Fails if the session was dropped after the job was opened.
+static int session_take_turn(DaemonJob *__restrict__ job) {
+    DaemonSession *session = job->session;
+    pthread_mutex_lock(&session_lock);
+    int live = session->valid && !session->dropping && session->generation == job->generation;
+    if (live) {
+        job->seq = session->next_seq++;
+        if (job->drop) session->dropping = 1;
+    }
+    pthread_mutex_unlock(&session_lock);
+    return live;
+}
+
+
+static void enqueue(DaemonJob *__restrict__ job) {
+    pthread_mutex_lock(&job->client->lock);
+    job->client->pending++;
+    pthread_mutex_unlock(&job->client->lock);
+
+    pthread_mutex_lock(&queue_lock);
+    job->next = NULL;
+    if (queue_tail) queue_tail->next = job;
+    else queue_head = job;
+    queue_tail = job;
+    ++num_queued;
+    pthread_cond_signal(&queue_cond);
+    pthread_mutex_unlock(&queue_lock);
+}
+
+
+// Flags queued and running jobs of a client (all of them if id is NULL)
+static void cancel_jobs(const DaemonClient *c, const char *id, const int num_workers) {
+    pthread_mutex_lock(&queue_lock);
+    for (DaemonJob *job = queue_head; job; job = job->next)
+        if (job->client == c && (!id || strcmp(job->id, id) == 0)) job->stop = STOP_CANCELLED;
+    for (int w = 0; w < num_workers; w++)
+        if (running[w] && running[w]->client == c && (!id || strcmp(running[w]->id, id) == 0))
+            running[w]->stop = STOP_CANCELLED;
+    pthread_mutex_unlock(&queue_lock);
+}
+
+
+static void enforce_time_limits(const int num_workers) {
+    pthread_mutex_lock(&queue_lock);
+    for (DaemonJob *job = queue_head; job; job = job->next)
+        if (job->limit_ms > 0 && !job->stop && elapsed_ms(&job->start) >= job->limit_ms) job->stop = STOP_TIMEOUT;
+    for (int w = 0; w < num_workers; w++) {
+        DaemonJob *job = running[w];
+        if (job && job->limit_ms > 0 && !job->stop && elapsed_ms(&job->start) >= job->limit_ms) job->stop = STOP_TIMEOUT;
+    }
+    pthread_mutex_unlock(&queue_lock);
+}
+
+
+// Returns 0 when the daemon should shut down
+static int handle_line(DaemonClient *__restrict__ c, char *line, const int num_workers) {
+    if (c->filling) {
+        DaemonJob *job = c->filling;
+        if (strcmp(line, "END") == 0) {
+            c->filling = NULL;
+            if (job->session && !session_take_turn(job)) {
+                char msg[128];
+                snprintf(msg, sizeof(msg), "ERROR %s session dropped\n", job->id);
+                client_write(c, msg);
+                job_free(job);
+            }
+            else enqueue(job);
+        }
+        else if (job->session && line[0] == '-' && line[1]) {
+            if (job->num_removed == job->removed_cap)
+                job->removed = (char **)realloc(job->removed, (job->removed_cap = job->removed_cap ? 2 * job->removed_cap : 64) * sizeof(char *));
+            job->removed[job->num_removed++] = strdup(line + 1);
+        }
+        else if (line[0]) {
+            if (job->session && line[0] == '+') ++line;
+            if (!line[0]) return 1;
+            if (job->n == job->cap)
+                job->reads = (char **)realloc(job->reads, (job->cap = job->cap ? 2 * job->cap : 64) * sizeof(char *));
+            job->reads[job->n++] = strdup(line);
+        }
+        return 1;
+    }
+
+    char *cmd = strtok(line, " \t");
+    if (!cmd) return 1;
+
+    if (strcmp(cmd, "SOLVE") == 0 || strcmp(cmd, "UPDATE") == 0 || strcmp(cmd, "DROP") == 0) {
+        char *id = strtok(NULL, " \t");
+        if (!id) {
+            client_write(c, "ERROR - missing id\n");
+            return 1;
+        }
+
+        DaemonSession *session = NULL;
+        unsigned long long generation = 0;
+        if (cmd[0] != 'S') {
+            pthread_mutex_lock(&session_lock);
+            session = session_find(id);
+            if (session) generation = session->generation;
+            pthread_mutex_unlock(&session_lock);
+            if (!session) {
+                client_write(c, "ERROR - too many sessions\n");
+                return 1;
+            }
+        }
+
+        DaemonJob *job = (DaemonJob *)calloc(1, sizeof(DaemonJob));
+        snprintf(job->id, sizeof(job->id), "%s", id);
+        job->client = c;
+        job->session = session;
+        job->generation = generation;
+        if (cmd[0] == 'D') {
+            job->drop = 1;
+            session_take_turn(job);
+            enqueue(job);
+            return 1;
+        }
+        clock_gettime(CLOCK_MONOTONIC, &job->start);
+        for (char *opt; (opt = strtok(NULL, " \t")); ) {
+            if (strncmp(opt, "limit_ms=", 9) == 0) job->limit_ms = atoll(opt + 9);
+            else if (strcmp(opt, "mode=exact") == 0) job->mode = MODE_EXACT;
+            else if (strcmp(opt, "mode=approx") == 0) job->mode = MODE_APPROX;
+        }
+        c->filling = job;
+    }
+    else if (strcmp(cmd, "CANCEL") == 0) {
+        char *id = strtok(NULL, " \t");
+        if (id) cancel_jobs(c, id, num_workers);
+    }
+    else if (strcmp(cmd, "STATS") == 0) {
+        char msg[256];
+        pthread_mutex_lock(&queue_lock);
+        pthread_mutex_lock(&cache_lock);
+        snprintf(msg, sizeof(msg), "STATS done=%llu queued=%d running=%d workers=%d cache_hits=%llu cache_misses=%llu\n",
+            jobs_done, num_queued, num_running, num_workers, cache_hits, cache_misses);
+        pthread_mutex_unlock(&cache_lock);
+        pthread_mutex_unlock(&queue_lock);
+        client_write(c, msg);
+    }
+    else if (strcmp(cmd, "QUIT") == 0) {
+        return 0;
+    }
+    else {
+        client_write(c, "ERROR - unknown command\n");
+    }
+    return 1;
+}
+
+
+// Feeds newly read bytes to the line parser. Returns 0 on QUIT.
+static int client_feed(DaemonClient *__restrict__ c, const char *buf, const ssize_t len, const int num_workers) {
+    for (ssize_t k = 0; k < len; k++) {
+        if (buf[k] == '\n') {
+            c->line[c->line_len] = '\0';
+            if (c->line_len && c->line[c->line_len - 1] == '\r') c->line[c->line_len - 1] = '\0';
+            c->line_len = 0;
+            if (!handle_line(c, c->line, num_workers)) return 0;
+            continue;
+        }
+        if (c->line_len + 1 >= c->line_cap)
+            c->line = (char *)realloc(c->line, c->line_cap *= 2);
+        c->line[c->line_len++] = buf[k];
+    }
+    return 1;
+}
+
+
+static DaemonClient *client_new(const int in_fd, const int out_fd) {
+    DaemonClient *c = (DaemonClient *)calloc(1, sizeof(DaemonClient));
+    c->in_fd = in_fd;
+    c->out_fd = out_fd;
+    c->line_cap = READ_BUFFER_LEN;
+    c->line = (char *)malloc(c->line_cap);
+    pthread_mutex_init(&c->lock, NULL);
+    return c;
+}
+
+
+// Disconnected: its jobs are cancelled and it is freed once none refer to it
+static void client_close(DaemonClient *__restrict__ c, const int num_workers) {
+    if (c->filling) {
+        job_free(c->filling);
+        c->filling = NULL;
+    }
+    cancel_jobs(c, NULL, num_workers);
+    pthread_mutex_lock(&c->lock);
+    c->closed = 1;
+    int idle = c->pending == 0;
+    pthread_mutex_unlock(&c->lock);
+    if (idle) client_free(c);
+}
+
+
+static void io_loop(const int listen_fd, const int num_workers) {
+    DaemonClient *clients[DAEMON_MAX_CLIENTS];
+    int num_clients = 0, running_io = 1;
+
+    if (listen_fd < 0) clients[num_clients++] = client_new(STDIN_FILENO, STDOUT_FILENO);
+
+    while (running_io) {
+        struct pollfd fds[DAEMON_MAX_CLIENTS + 1];
+        int nfds = 0;
+        if (listen_fd >= 0) fds[nfds++] = (struct pollfd){listen_fd, POLLIN, 0};
+        for (int k = 0; k < num_clients; k++)
+            fds[nfds++] = (struct pollfd){clients[k]->in_fd, POLLIN, 0};
+
+        int ready = poll(fds, nfds, DAEMON_POLL_MS);
+        enforce_time_limits(num_workers);
+        if (ready <= 0) continue;
+
+        int base = 0;
+        if (listen_fd >= 0) {
+            base = 1;
+            if (fds[0].revents & POLLIN) {
+                int fd = accept(listen_fd, NULL, NULL);
+                if (fd >= 0 && num_clients < DAEMON_MAX_CLIENTS) clients[num_clients++] = client_new(fd, fd);
+                else if (fd >= 0) close(fd);
+            }
+        }
+
+        for (int k = base; k < nfds && running_io; k++) {
+            if (!fds[k].revents) continue;
+            DaemonClient *c = clients[k - base];
+            char buf[65536];
+            ssize_t len = read(c->in_fd, buf, sizeof(buf));
+            if (len < 0 && errno == EINTR) continue;
+
+            if (len > 0 && client_feed(c, buf, len, num_workers)) continue;
+            if (len > 0) running_io = 0;   // QUIT
+
+            // End of input: on stdin, let the queued work finish first,
+            // still within its time limits
+            if (listen_fd < 0) {
+                for (;;) {
+                    pthread_mutex_lock(&queue_lock);
+                    int busy = num_queued || num_running;
+                    pthread_mutex_unlock(&queue_lock);
+                    if (!busy) break;
+                    enforce_time_limits(num_workers);
+                    usleep(DAEMON_POLL_MS * 1000);
+                }
+                running_io = 0;
+            }
+            client_close(c, num_workers);
+            clients[k - base] = NULL;
+        }
+
+        int kept = 0;
+        for (int k = 0; k < num_clients; k++)
+            if (clients[k]) clients[kept++] = clients[k];
+        num_clients = kept;
+    }
+
+    for (int k = 0; k < num_clients; k++)
+        client_close(clients[k], num_workers);
+
+    pthread_mutex_lock(&queue_lock);
+    shutting_down = 1;
+    pthread_cond_broadcast(&queue_cond);
+    pthread_mutex_unlock(&queue_lock);
+}
+
+
+static int open_socket(const char *path) {
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        perror("socket");
+        return -1;
+    }
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    snprintf(addr.sun_path, sizeof(addr.sun_path), "%s", path);
+    unlink(path);
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 || listen(fd, DAEMON_MAX_CLIENTS) != 0) {
+        perror(path);
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+
+int main(int argc, char *argv[]) {
+
+    const char *socket_path = NULL;
+    int use_stdio = 0, num_workers = omp_get_num_procs();
+    for (int a = 1; a < argc; a++) {
+        if (strncmp(argv[a], "--socket=", 9) == 0) socket_path = argv[a] + 9;
+        else if (strcmp(argv[a], "--stdio") == 0) use_stdio = 1;
+        else if (strncmp(argv[a], "--workers=", 10) == 0) num_workers = atoi(argv[a] + 10);
+    }
+
+    if ((!socket_path) == (!use_stdio) || num_workers < 1) {
+        fprintf(stderr, "Usage: %s --socket=path | --stdio [--workers=N]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    signal(SIGPIPE, SIG_IGN);
+    int listen_fd = -1;
+    if (socket_path && (listen_fd = open_socket(socket_path)) < 0) return EXIT_FAILURE;
+    fprintf(stderr, "Solver daemon ready, %d workers, %s\n", num_workers, socket_path ? socket_path : "stdio");
+
+    running = (DaemonJob **)calloc(num_workers, sizeof(DaemonJob *));
+    omp_set_dynamic(0);
+
+    // The OpenMP team is the warm pool: thread 0 serves I/O, the rest solve.
+    // Parallel regions inside a job are nested and run on its worker alone.
+    #pragma omp parallel num_threads(num_workers + 1)
+    {
+        if (omp_get_thread_num() == 0) io_loop(listen_fd, num_workers);
+        else worker_loop(omp_get_thread_num() - 1);
+    }
+
+    if (listen_fd >= 0) {
+        close(listen_fd);
+        unlink(socket_path);
+    }
+    for (int e = 0; e < DAEMON_CACHE_ENTRIES; e++)
+        if (cache[e].valid) read_set_free(&cache[e].rs);
+    for (int k = 0; k < DAEMON_MAX_SESSIONS; k++)
+        if (sessions[k].valid) incremental_free(&sessions[k].set);
+    free(running);
+    return 0;
+}
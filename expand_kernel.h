@@ -0,0 +1,51 @@
+#ifndef EXPAND_KERNEL_H
+#define EXPAND_KERNEL_H
+
+#include <stdint.h>
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+// Children are evaluated in blocks of 32, one bit per child.
+// Cost rows must be padded to a multiple of EXPAND_BLOCK entries
+// and aligned to 64 bytes.
+#define EXPAND_BLOCK 32
+
+// Batched child evaluation for the branch-and-bound inner loop.
+//
+// cost_row[i] holds len[i] - overlap[last][i], i.e. how much the
+// superstring grows when read i is appended after read last.
+// avail has a bit set for every child still unused in this block.
+// A child survives the bound when curr_len + cost < best_len,
+// so the caller passes limit = best_len - curr_len.
+static inline uint32_t expand_children32(const int *__restrict__ cost_row, uint32_t avail, int limit) {
+    if (!avail) return 0;
+
+#if defined(__AVX512F__)
+    __m512i lim = _mm512_set1_epi32(limit);
+    uint32_t lo = _mm512_cmplt_epi32_mask(_mm512_load_si512((const void *)cost_row), lim);
+    uint32_t hi = _mm512_cmplt_epi32_mask(_mm512_load_si512((const void *)(cost_row + 16)), lim);
+    return (lo | (hi << 16)) & avail;
+#elif defined(__AVX2__)
+    __m256i lim = _mm256_set1_epi32(limit);
+    uint32_t bits = 0;
+    for (int k = 0; k < 4; k++) {
+        __m256i v = _mm256_load_si256((const __m256i *)(cost_row + 8 * k));
+        __m256i lt = _mm256_cmpgt_epi32(lim, v);
+        bits |= (uint32_t)_mm256_movemask_ps(_mm256_castsi256_ps(lt)) << (8 * k);
+    }
+    return bits & avail;
+#else
+    // Without vector units only the unused children are worth touching
+    uint32_t bits = 0;
+    while (avail) {
+        int k = __builtin_ctz(avail);
+        bits |= (uint32_t)(cost_row[k] < limit) << k;
+        avail &= avail - 1;
+    }
+    return bits;
+#endif
+}
+
+#endif
@@ -0,0 +1,256 @@
+#ifndef INCREMENTAL_H
+#define INCREMENTAL_H
+
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+#include "overlap_matrix.h"
+#include "search_kernel.h"
+#include "beam_search.h"
+#include "window_opt.h"
+
+#define INCREMENTAL_BEAM_WIDTH 64
+
+
+// A read set that changes over time, with what the last solve learned:
+// the best ordering and the per-read lower bounds. Each update only
+// computes the overlaps that involve new reads, and the next solve starts
+// from the previous ordering.
+typedef struct incremental_set{
+    ReadSet rs;
+    int *order;     // best known ordering of rs
+    int best_len;
+    int optimal;    // order is proven optimal
+    int *lb_cost;   // len[j] - best incoming overlap of j, as in BeamContext
+    int *lb_from;   // the read giving that overlap, -1 if none
+    int lb_total;
+} IncrementalSet;
+
+
+static inline void incremental_init(IncrementalSet *__restrict__ s) {
+    memset(s, 0, sizeof(IncrementalSet));
+}
+
+
+static inline void incremental_free(IncrementalSet *__restrict__ s) {
+    read_set_free(&s->rs);
+    free(s->order);
+    free(s->lb_cost);
+    free(s->lb_from);
+    memset(s, 0, sizeof(IncrementalSet));
+}
+
+
+// Best incoming overlap of read j over the whole set, O(n)
+static inline void incremental_lb_column(IncrementalSet *__restrict__ s, const int j) {
+    const ReadSet *rs = &s->rs;
+    s->lb_cost[j] = rs->len[j];
+    s->lb_from[j] = -1;
+    for (int i = 0; i < rs->n; i++) {
+        int add = rs->len[j] - rs->overlap[(size_t)i * rs->n + j];
+        if (i != j && add < s->lb_cost[j]) {
+            s->lb_cost[j] = add;
+            s->lb_from[j] = i;
+        }
+    }
+}
+
+
+// Admissible bound on any superstring of the set: the first read costs its
+// full length, every other read at least its lb_cost
+static inline int incremental_lower_bound(const IncrementalSet *__restrict__ s) {
+    int best = s->rs.n ? INT_MAX : 0;
+    for (int f = 0; f < s->rs.n; f++) {
+        int bound = s->lb_total - s->lb_cost[f] + s->rs.len[f];
+        if (bound < best) best = bound;
+    }
+    return best;
+}
+
+
+// Drops one copy of each listed read. Surviving rows and columns of the
+// matrix are moved, not recomputed; only lower bounds that came from a
+// removed read are rebuilt. Returns the number of reads removed.
+static inline int incremental_remove(IncrementalSet *__restrict__ s, char *const *reads, const int k) {
+    ReadSet *rs = &s->rs;
+    const int n = rs->n;
+    int *map = (int *)malloc((n ? n : 1) * sizeof(int));   // old index to new, -1 if removed
+    for (int i = 0; i < n; i++)
+        map[i] = 0;
+
+    int removed = 0;
+    for (int r = 0; r < k; r++) {
+        for (int i = 0; i < n; i++) {
+            if (map[i] == 0 && strcmp(rs->reads[i], reads[r]) == 0) {
+                map[i] = -1;
+                ++removed;
+                break;
+            }
+        }
+    }
+    if (!removed) {
+        free(map);
+        return 0;
+    }
+
+    const int m = n - removed;
+    for (int i = 0, next = 0; i < n; i++) {
+        if (map[i] < 0) free(rs->reads[i]);
+        else map[i] = next++;
+    }
+
+    int *overlap = (int *)malloc((size_t)(m ? m : 1) * m * sizeof(int));
+    for (int i = 0; i < n; i++) {
+        if (map[i] < 0) continue;
+        for (int j = 0; j < n; j++)
+            if (map[j] >= 0) overlap[(size_t)map[i] * m + map[j]] = rs->overlap[(size_t)i * n + j];
+    }
+    free(rs->overlap);
+    rs->overlap = overlap;
+
+    int stale = 0;
+    for (int i = 0; i < n; i++) {
+        if (map[i] < 0) continue;
+        const int j = map[i], from = s->lb_from[i];
+        rs->reads[j] = rs->reads[i];
+        rs->len[j] = rs->len[i];
+        s->lb_cost[j] = s->lb_cost[i];
+        // a bound that came from a removed read is rebuilt below
+        s->lb_from[j] = from < 0 ? -1 : map[from] >= 0 ? map[from] : INT_MIN;
+        if (s->lb_from[j] == INT_MIN) stale = 1;
+    }
+    rs->n = m;
+
+    for (int j = 0; stale && j < m; j++)
+        if (s->lb_from[j] == INT_MIN) incremental_lb_column(s, j);
+    s->lb_total = 0;
+    for (int j = 0; j < m; j++)
+        s->lb_total += s->lb_cost[j];
+
+    // Dropping a read from an ordering never lengthens it
+    int kept = 0;
+    for (int p = 0; p < n; p++)
+        if (map[s->order[p]] >= 0) s->order[kept++] = map[s->order[p]];
+    s->best_len = order_length(rs, s->order);
+    s->optimal = 0;
+
+    free(map);
+    return removed;
+}
+
+
+// Appends reads, computing only the 2 * k * n + k * k overlaps that involve
+// them. The old block of the matrix is copied over to keep stride n.
+static inline void incremental_add(IncrementalSet *__restrict__ s, char *const *reads, const int k) {
+    if (k == 0) return;
+    ReadSet *rs = &s->rs;
+    const int n = rs->n, m = n + k;
+
+    rs->reads = (char **)realloc(rs->reads, m * sizeof(char *));
+    rs->len = (int *)realloc(rs->len, m * sizeof(int));
+    s->order = (int *)realloc(s->order, m * sizeof(int));
+    s->lb_cost = (int *)realloc(s->lb_cost, m * sizeof(int));
+    s->lb_from = (int *)realloc(s->lb_from, m * sizeof(int));
+    for (int r = 0; r < k; r++) {
+        rs->reads[n + r] = strdup(reads[r]);
+        rs->len[n + r] = strlen(reads[r]);
+    }
+
+    int *overlap = (int *)malloc((size_t)m * m * sizeof(int));
+    for (int i = 0; i < n; i++)
+        memcpy(overlap + (size_t)i * m, rs->overlap + (size_t)i * n, n * sizeof(int));
+    free(rs->overlap);
+    rs->overlap = overlap;
+    rs->n = m;
+
+    #pragma omp parallel for schedule(dynamic, 16)
+    for (int i = 0; i < m; i++) {
+        // old rows only need the new columns, new rows need all of them
+        for (int j = i < n ? n : 0; j < m; j++) {
+            overlap[(size_t)i * m + j] = i == j ? 0 :
+                compute_overlap(rs->reads[i], rs->len[i], rs->reads[j], rs->len[j]);
+        }
+    }
+
+    // Old bounds can only improve through the new rows
+    for (int j = 0; j < n; j++) {
+        for (int i = n; i < m; i++) {
+            int add = rs->len[j] - overlap[(size_t)i * m + j];
+            if (add < s->lb_cost[j]) {
+                s->lb_cost[j] = add;
+                s->lb_from[j] = i;
+            }
+        }
+    }
+    for (int j = n; j < m; j++)
+        incremental_lb_column(s, j);
+    s->lb_total = 0;
+    for (int j = 0; j < m; j++)
+        s->lb_total += s->lb_cost[j];
+
+    // Repair the previous ordering: each new read goes where it adds least
+    for (int r = n; r < m; r++) {
+        const int len = r;   // reads placed so far
+        int best_pos = 0, best_delta = INT_MAX;
+        for (int p = 0; p <= len; p++) {
+            int prev = p > 0 ? s->order[p - 1] : -1, next = p < len ? s->order[p] : -1;
+            int delta = window_step(rs, prev, r) - (next >= 0 ? window_step(rs, prev, next) : 0) +
+                (next >= 0 ? window_step(rs, r, next) : 0);
+            if (delta < best_delta) {
+                best_delta = delta;
+                best_pos = p;
+            }
+        }
+        memmove(s->order + best_pos + 1, s->order + best_pos, (len - best_pos) * sizeof(int));
+        s->order[best_pos] = r;
+    }
+    s->best_len = order_length(rs, s->order);
+    s->optimal = 0;
+}
+
+
+// Re-solves after updates, warm started from the repaired ordering. An
+// ordering that meets the lower bound is optimal without any search. With
+// exact set, solve_exact runs under the repaired length as its bound;
+// otherwise the ordering is improved by window re-optimization. Either
+// may be stopped through *stop with the best ordering so far. A set solved from scratch is seeded by beam search.
+// Returns the superstring length.
+static inline int incremental_solve(IncrementalSet *__restrict__ s, const int exact, const int window,
+    const int cold, unsigned long long *__restrict__ num_nodes, const volatile int *stop = nullptr) {
+
+    const ReadSet *rs = &s->rs;
+    if (s->optimal || rs->n == 0) {
+        s->optimal = 1;
+        return s->best_len;
+    }
+
+    if (cold) {
+        BeamContext ctx;
+        beam_context_init(&ctx, rs);
+        int *order = (int *)malloc(rs->n * sizeof(int));
+        int len = beam_search(&ctx, INCREMENTAL_BEAM_WIDTH, order, stop);
+        if (len < s->best_len) {
+            s->best_len = len;
+            memcpy(s->order, order, rs->n * sizeof(int));
+        }
+        free(order);
+        beam_context_free(&ctx);
+    }
+
+    if (s->best_len == incremental_lower_bound(s)) {
+        s->optimal = 1;
+        return s->best_len;
+    }
+
+    if (exact && rs->n <= SEARCH_KERNEL_MAX_READS) {
+        s->best_len = solve_exact(rs->n, rs->len, rs->overlap, rs->n, s->best_len, s->order, num_nodes, -1, stop);
+        s->optimal = !(stop && *stop);
+    }
+    else {
+        s->best_len = window_optimize(rs, s->order, window, NULL, stop);
+    }
+    return s->best_len;
+}
+
+#endif
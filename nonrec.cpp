@@ -3,6 +3,10 @@
 #include <string.h>
 #include <limits.h>
 #include <string.h>
+#include <stdint.h>
+
+#include "search_kernel.h"
+#include "approx_overlap.h"
 
 
 //#define MAX_READS 12
@@ -53,27 +57,32 @@ char *reads[MAX_READS] = {
 
 
 int overlap[MAX_READS][MAX_READS];
+int read_len[MAX_READS];
 int best_len = 1e9;
+int best_order[MAX_READS];
 char best_result[MAX_READS * MAX_LEN];
-
-// Compute maximum overlap between two strings
-int compute_overlap(const char *__restrict__ a, const char *__restrict__b) {
-    int max = 0;
-    int len_a = strlen(a);
-    int len_b = strlen(b);
-    for (int i = 1; i <= len_a && i <= len_b; i++) {
-        if (strncmp(a + len_a - i, b, i) == 0)
-            max = i;
-    }
-    return max;
-}
+ApproxParams approx_params = {0, APPROX_MIN_OVERLAP, 1};
 
 // Build the overlap matrix once
 void build_overlap_matrix() {
+    for (int i = 0; i < n_reads; i++)
+        read_len[i] = strlen(reads[i]);
+
+    if (approx_params.max_errors > 0) {
+        static ApproxPattern patterns[MAX_READS];
+        for (int i = 0; i < n_reads; i++)
+            approx_pattern_prepare(reads[i], read_len[i], &patterns[i]);
+        for (int i = 0; i < n_reads; i++) {
+            for (int j = 0; j < n_reads; j++)
+                overlap[i][j] = i != j ? approx_overlap(&patterns[i], &patterns[j], &approx_params) : 0;
+        }
+        return;
+    }
+
     for (int i = 0; i < n_reads; i++) {
         for (int j = 0; j < n_reads; j++) {
             if (i != j)
-                overlap[i][j] = compute_overlap(reads[i], reads[j]);
+                overlap[i][j] = compute_overlap(reads[i], read_len[i], reads[j], read_len[j]);
             else
                 overlap[i][j] = 0;
         }
@@ -81,10 +90,11 @@ void build_overlap_matrix() {
 }
 
 // Greedy upper bound: build an initial (suboptimal) superstring
-int greedy_superstring_length() {
+int greedy_superstring_length(int *order) {
     int used[MAX_READS] = {0};
-    int curr = 0, total_len = strlen(reads[0]);
+    int curr = 0, total_len = read_len[0];
     used[0] = 1;
+    order[0] = 0;
 
     for (int step = 1; step < n_reads; step++) {
         int max_ov = -1, next = -1;
@@ -94,60 +104,55 @@ int greedy_superstring_length() {
                 next = i;
             }
         }
-        total_len += strlen(reads[next]) - max_ov;
+        total_len += read_len[next] - max_ov;
         used[next] = 1;
+        order[step] = next;
         curr = next;
     }
     return total_len;
 }
 
-void dfs(int last, int used_mask, int curr_len, char *curr_str) {
-    if (used_mask == (1 << n_reads) - 1) {
-        if (curr_len < best_len) {
-            best_len = curr_len;
-            strcpy(best_result, curr_str);
-        }
-        return;
-    }
-
-    for (int i = 0; i < n_reads; i++) {
-        if (!(used_mask & (1 << i))) {
-            int ov = overlap[last][i];
-            int new_len = curr_len + strlen(reads[i]) - ov;
-
-            if (new_len >= best_len) continue; // pruning
-
-            char new_str[MAX_READS * MAX_LEN];
-            strcpy(new_str, curr_str);
-            strcat(new_str, reads[i] + ov);
-
-            dfs(i, used_mask | (1 << i), new_len, new_str);
-        }
-    }
+// Spell out the superstring for an ordering of the reads
+void build_superstring(const int *order, char *out) {
+    strcpy(out, reads[order[0]]);
+    for (int k = 1; k < n_reads; k++)
+        strcat(out, reads[order[k]] + overlap[order[k - 1]][order[k]]);
 }
 
 void solve() {
     build_overlap_matrix();
-    best_len = greedy_superstring_length();  // initial bound
+    best_len = greedy_superstring_length(best_order);  // initial bound
 
-    for (int i = 0; i < n_reads; i++) {
-        char curr[MAX_READS * MAX_LEN];
-        strcpy(curr, reads[i]);
-        dfs(i, 1 << i, strlen(curr), curr);
+    // The search only tracks the ordering; the string is built once at the end
+    unsigned long long num_nodes = 0;
+    best_len = solve_exact(n_reads, read_len, &overlap[0][0], MAX_READS, best_len, best_order, &num_nodes);
+    if (best_len < 0) {
+        fprintf(stderr, "Exact search supports at most %d reads\n", SEARCH_KERNEL_MAX_READS);
+        exit(EXIT_FAILURE);
     }
 
+    build_superstring(best_order, best_result);
     printf("Best superstring (%d chars):\n%s\n", best_len, best_result);
+    printf("Nodes explored: %llu\n", num_nodes);
 }
 
 int main(int argc, char *argv[]){
 
     
-    if (argc < 2) {
-        fprintf(stderr, "Usage: %s <input_file>\n", argv[0]);
+    const char *filename = NULL;
+    for (int a = 1; a < argc; a++) {
+        if (strncmp(argv[a], "--errors=", 9) == 0) approx_params.max_errors = atoi(argv[a] + 9);
+        else if (strncmp(argv[a], "--min-overlap=", 14) == 0) approx_params.min_overlap = atoi(argv[a] + 14);
+        else if (strcmp(argv[a], "--hamming") == 0) approx_params.edits = 0;
+        else filename = argv[a];
+    }
+
+    if (!filename) {
+        fprintf(stderr, "Usage: %s <input_file> [--errors=k] [--min-overlap=len] [--hamming]\n", argv[0]);
         return EXIT_FAILURE;
     }
     
-    read_file(argv[1]);
+    read_file(filename);
     solve();
     return 0;
 
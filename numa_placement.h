@@ -0,0 +1,124 @@
+#ifndef NUMA_PLACEMENT_H
+#define NUMA_PLACEMENT_H
+
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define NUMA_MAX_NODES 64
+#define CACHE_LINE 64
+
+
+// CPUs this process may run on, grouped by NUMA node. Only nodes with at
+// least one allowed CPU are kept, renumbered from 0.
+typedef struct numa_topology{
+    int num_nodes;
+    int num_cpus[NUMA_MAX_NODES];
+    cpu_set_t cpus[NUMA_MAX_NODES];
+} NumaTopology;
+
+
+// Kernel cpulist syntax: "0-3,8-11"
+static inline void numa_parse_cpulist(const char *__restrict__ list, cpu_set_t *__restrict__ set) {
+    CPU_ZERO(set);
+    while (*list) {
+        char *end;
+        long first = strtol(list, &end, 10), last = first;
+        if (end == list) break;
+        if (*end == '-') last = strtol(end + 1, &end, 10);
+        for (long c = first; c <= last && c < CPU_SETSIZE; c++)
+            CPU_SET(c, set);
+        list = *end == ',' ? end + 1 : end;
+    }
+}
+
+
+// Reads the node layout from sysfs; without it every allowed CPU is one node
+static inline void numa_topology_detect(NumaTopology *__restrict__ topo) {
+    cpu_set_t allowed;
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+        CPU_ZERO(&allowed);
+        CPU_SET(0, &allowed);
+    }
+
+    topo->num_nodes = 0;
+    for (int node = 0; node < 1024 && topo->num_nodes < NUMA_MAX_NODES; node++) {
+        char path[128], list[4096];
+        snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", node);
+        FILE *fp = fopen(path, "r");
+        if (!fp) continue;
+        int ok = fgets(list, sizeof(list), fp) != NULL;
+        fclose(fp);
+        if (!ok) continue;
+
+        cpu_set_t *set = &topo->cpus[topo->num_nodes];
+        numa_parse_cpulist(list, set);
+        CPU_AND(set, set, &allowed);
+        int count = CPU_COUNT(set);
+        if (count > 0)
+            topo->num_cpus[topo->num_nodes++] = count;
+    }
+
+    if (topo->num_nodes == 0) {
+        topo->num_nodes = 1;
+        topo->cpus[0] = allowed;
+        topo->num_cpus[0] = CPU_COUNT(&allowed);
+    }
+}
+
+
+// Threads are dealt to nodes in contiguous blocks, so the threads of one
+// node have consecutive ids. With fewer threads than nodes only the first
+// num_threads nodes get any.
+static inline int numa_active_nodes(const NumaTopology *__restrict__ topo, const int num_threads) {
+    return num_threads < topo->num_nodes ? num_threads : topo->num_nodes;
+}
+
+static inline int numa_total_cpus(const NumaTopology *__restrict__ topo) {
+    int total = 0;
+    for (int node = 0; node < topo->num_nodes; node++)
+        total += topo->num_cpus[node];
+    return total;
+}
+
+// First thread of a node's block; node == active gives num_threads. Each
+// active node gets one thread, the rest are shared in proportion to the
+// node's allowed CPUs.
+static inline int numa_node_first_thread(const NumaTopology *__restrict__ topo, const int node, const int num_threads) {
+    const int active = numa_active_nodes(topo, num_threads);
+    long cpus_before = 0, cpus_active = 0;
+    for (int k = 0; k < active; k++) {
+        if (k < node) cpus_before += topo->num_cpus[k];
+        cpus_active += topo->num_cpus[k];
+    }
+    return node + (int)(((num_threads - active) * cpus_before + cpus_active / 2) / cpus_active);
+}
+
+static inline int numa_thread_node(const NumaTopology *__restrict__ topo, const int thread, const int num_threads) {
+    int node = numa_active_nodes(topo, num_threads) - 1;
+    while (node > 0 && numa_node_first_thread(topo, node, num_threads) > thread)
+        --node;
+    return node;
+}
+
+// Position of the thread among the threads of its node; 0 is the node leader
+static inline int numa_thread_rank(const NumaTopology *__restrict__ topo, const int thread, const int num_threads) {
+    return thread - numa_node_first_thread(topo, numa_thread_node(topo, thread, num_threads), num_threads);
+}
+
+
+// Binds the calling thread to one CPU of its node, round robin by rank
+static inline void numa_pin_thread(const NumaTopology *__restrict__ topo, const int node, const int rank) {
+    int target = rank % topo->num_cpus[node];
+    for (int c = 0; c < CPU_SETSIZE; c++) {
+        if (!CPU_ISSET(c, &topo->cpus[node]) || target--) continue;
+        cpu_set_t one;
+        CPU_ZERO(&one);
+        CPU_SET(c, &one);
+        sched_setaffinity(0, sizeof(one), &one);
+        return;
+    }
+}
+
+#endif
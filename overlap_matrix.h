@@ -0,0 +1,144 @@
+#ifndef OVERLAP_MATRIX_H
+#define OVERLAP_MATRIX_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#define READ_BUFFER_LEN 256
+
+// A read set sized at load time, for engines that go well past the
+// fixed MAX_READS arrays of the exact solvers.
+typedef struct read_set{
+    int n;
+    char **reads;
+    int *len;
+    int *overlap;   // n * n, overlap[i * n + j] = overlap of i followed by j
+} ReadSet;
+
+
+// Loops over independent rows and windows run as a parallel for from serial
+// code. Inside a parallel region, e.g. from a task of batch.cpp, a nested
+// parallel for would be inactive, so they are issued as a taskloop instead.
+static inline int in_parallel_region() {
+#ifdef _OPENMP
+    return omp_in_parallel();
+#else
+    return 0;
+#endif
+}
+
+
+// Maximum suffix of a that is a prefix of b
+static inline int compute_overlap(const char *__restrict__ a, const int len_a,
+    const char *__restrict__ b, const int len_b) {
+
+    int max = len_a < len_b ? len_a : len_b;
+    for (int i = max; i > 0; i--) {
+        if (strncmp(a + len_a - i, b, i) == 0)
+            return i;
+    }
+    return 0;
+}
+
+
+// One read per line, blank lines skipped. Returns 0 on failure.
+static inline int read_set_load(const char *filename, ReadSet *__restrict__ rs) {
+    FILE *fp = fopen(filename, "r");
+    if (!fp) {
+        perror("File open failed");
+        return 0;
+    }
+
+    int capacity = 64;
+    memset(rs, 0, sizeof(ReadSet));
+    rs->reads = (char **)malloc(capacity * sizeof(char *));
+
+    char buffer[READ_BUFFER_LEN];
+    while (fgets(buffer, sizeof(buffer), fp)) {
+        buffer[strcspn(buffer, "\r\n")] = 0;  // Strip newline
+        if (!buffer[0]) continue;
+        if (rs->n == capacity) {
+            capacity *= 2;
+            rs->reads = (char **)realloc(rs->reads, capacity * sizeof(char *));
+        }
+        rs->reads[rs->n++] = strdup(buffer);
+    }
+    fclose(fp);
+
+    rs->len = (int *)malloc((rs->n ? rs->n : 1) * sizeof(int));
+    for (int i = 0; i < rs->n; i++)
+        rs->len[i] = strlen(rs->reads[i]);
+    return 1;
+}
+
+
+// Once *stop is set, rows are left at zero overlap: still a valid (if
+// poor) matrix, since any ordering then spells a real superstring
+static inline void read_set_overlap_row(ReadSet *__restrict__ rs, const int i, const volatile int *stop) {
+    const int n = rs->n;
+    const int skip = stop && *stop;
+    for (int j = 0; j < n; j++) {
+        rs->overlap[(size_t)i * n + j] = i == j || skip ? 0 :
+            compute_overlap(rs->reads[i], rs->len[i], rs->reads[j], rs->len[j]);
+    }
+}
+
+
+// All-pairs overlaps, rows are independent so they are built in parallel.
+// Returns 0 if *stop cut the build short.
+static inline int read_set_build_overlaps(ReadSet *__restrict__ rs, const volatile int *stop = nullptr) {
+    const int n = rs->n;
+    rs->overlap = (int *)malloc((size_t)(n ? n : 1) * n * sizeof(int));
+
+    if (in_parallel_region()) {
+        #pragma omp taskloop grainsize(16)
+        for (int i = 0; i < n; i++)
+            read_set_overlap_row(rs, i, stop);
+    }
+    else {
+        #pragma omp parallel for schedule(dynamic, 16)
+        for (int i = 0; i < n; i++)
+            read_set_overlap_row(rs, i, stop);
+    }
+    return !(stop && *stop);
+}
+
+
+static inline void read_set_free(ReadSet *__restrict__ rs) {
+    for (int i = 0; i < rs->n; i++)
+        free(rs->reads[i]);
+    free(rs->reads);
+    free(rs->len);
+    free(rs->overlap);
+    memset(rs, 0, sizeof(ReadSet));
+}
+
+
+// Length of the superstring spelled by an ordering of the reads
+static inline int order_length(const ReadSet *__restrict__ rs, const int *__restrict__ order) {
+    if (rs->n == 0) return 0;
+    int total = rs->len[order[0]];
+    for (int k = 1; k < rs->n; k++)
+        total += rs->len[order[k]] - rs->overlap[(size_t)order[k - 1] * rs->n + order[k]];
+    return total;
+}
+
+
+// Spell the superstring of an ordering; the caller frees the result
+static inline char *order_superstring(const ReadSet *__restrict__ rs, const int *__restrict__ order) {
+    char *out = (char *)malloc(order_length(rs, order) + 1);
+    char *p = out;
+    for (int k = 0; k < rs->n; k++) {
+        int ov = k ? rs->overlap[(size_t)order[k - 1] * rs->n + order[k]] : 0;
+        memcpy(p, rs->reads[order[k]] + ov, rs->len[order[k]] - ov);
+        p += rs->len[order[k]] - ov;
+    }
+    *p = '\0';
+    return out;
+}
+
+#endif
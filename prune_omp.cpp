@@ -4,11 +4,21 @@
 #include <limits.h>
 #include <string.h>
 #include <time.h> 
+#include <errno.h>
+#include <omp.h>
+
+#include "numa_placement.h"
 
 
 #define MAX_READS 20
 #define MAX_LEN 100
 #define POOL_SIZE 10000
+#define NUM_PROBES 2000
+#define TASKS_PER_WORKER 16
+#define CHECKPOINT_INTERVAL 60
+#define CHECKPOINT_POLL 65536   // overlap verifications between clock checks
+#define CHECKPOINT_MAGIC 0x4B435353u  // "SSCK"
+#define CHECKPOINT_VERSION 1
 #define MAX_SUPERSTRING_LEN (MAX_READS * MAX_LEN)
 
 
@@ -16,6 +26,7 @@ char reads[MAX_READS][MAX_LEN];
 
 int num_reads = 0;
 unsigned int num_subproblems = 0;
+int pool_overflow = 0;
 unsigned long long num_solutions = 0ULL;
 unsigned long long num_overlap_verifications    = 0ULL;
 
@@ -23,12 +34,78 @@ int best_len = INT_MAX;
 char best_result[MAX_LEN * MAX_READS];
 
 
+// Per-node search state, allocated and first touched by a thread of that
+// node so its pages are local. The search reads the replica and the node
+// copy of the incumbent; only the dequeue counter is written often, and it
+// sits on its own cache line.
+typedef struct node_state{
+    alignas(CACHE_LINE) char (*reads)[MAX_LEN];
+    volatile int best_len;
+    unsigned int begin, end;   // this node's slice of the pool
+    alignas(CACHE_LINE) unsigned int next;
+} NodeState;
+
+NumaTopology topology;
+int num_active_nodes = 1;
+NodeState *node_state[NUMA_MAX_NODES];
+
+
+// What one thread needs while solving: counters stay here and are
+// flushed to the globals once per subproblem
+typedef struct search_context{
+    const char (*reads)[MAX_LEN];
+    const volatile int *best_len;
+    unsigned long long num_solutions;
+    unsigned long long num_overlap_verifications;
+    unsigned int until_poll;   // verifications left before the checkpoint clock is read
+} SearchContext;
+
+
+typedef struct tree_estimate{
+    double nodes_per_level[MAX_READS + 1];  // estimated nodes with `level` reads placed
+    double total_nodes;
+    double total_overlap_verifications;
+    double seconds_per_verification;
+} TreeEstimate;
+
+
 typedef struct subproblem{
     char current[MAX_LEN * MAX_READS] = "";
     int used[MAX_READS] = {0};
+    unsigned char prefix[MAX_READS] = {0};  // reads placed so far, in order
 } Subproblems;
 
 
+// On-disk layout: header, best_result bytes, then per open subproblem
+// its used mask and its cutoff_level-long permutation prefix.
+typedef struct checkpoint_header{
+    unsigned int magic;
+    unsigned int version;
+    unsigned int num_reads;
+    unsigned int reads_hash;
+    int cutoff_level;
+    int best_len;
+    unsigned int best_result_len;
+    unsigned int num_subproblems;
+    unsigned long long num_solutions;
+    unsigned long long num_overlap_verifications;
+} CheckpointHeader;
+
+
+const char *checkpoint_path = NULL;
+int checkpoint_interval = CHECKPOINT_INTERVAL;
+int checkpoint_delay = CHECKPOINT_INTERVAL;   // grows while writes keep failing
+time_t last_checkpoint = 0;
+
+// The frontier being solved, for checkpoints taken in the middle of a subproblem
+const Subproblems *checkpoint_pool = NULL;
+unsigned int checkpoint_pool_size = 0;
+unsigned char *checkpoint_done = NULL;
+int checkpoint_cutoff = 0;
+
+void maybe_checkpoint();
+
+
 int overlap(const char *__restrict__ a, const char *__restrict__ b) {
     int max = strlen(a) < strlen(b) ? strlen(a) : strlen(b);
     for (int i = max; i > 0; i--) {
@@ -40,15 +117,163 @@ int overlap(const char *__restrict__ a, const char *__restrict__ b) {
 }
 
 
+// Nearest-neighbour superstring from every starting read, keeps the shortest
+// as the incumbent so the estimator and the search start with a finite bound
+void seed_incumbent_greedy(){
+
+    for (int start = 0; start < num_reads; start++) {
+        char current[MAX_LEN * MAX_READS];
+        int used[MAX_READS] = {0};
+
+        strcpy(current, reads[start]);
+        used[start] = 1;
+
+        for (int level = 1; level < num_reads; level++) {
+            int next = -1, best_ov = -1;
+            for (int i = 0; i < num_reads; i++) {
+                if (!used[i]) {
+                    int ov = overlap(current, reads[i]);
+                    if (ov > best_ov) {
+                        best_ov = ov;
+                        next = i;
+                    }
+                }
+            }
+            used[next] = 1;
+            strcat(current, reads[next] + best_ov);
+        }
+
+        if ((int)strlen(current) < best_len) {
+            best_len = strlen(current);
+            strcpy(best_result, current);
+        }
+    }
+}
+
+
+static unsigned long long probe_rng_state = 0x9E3779B97F4A7C15ULL;
+
+static unsigned int probe_rand(){
+    probe_rng_state ^= probe_rng_state << 13;
+    probe_rng_state ^= probe_rng_state >> 7;
+    probe_rng_state ^= probe_rng_state << 17;
+    return (unsigned int)(probe_rng_state >> 32);
+}
+
+
+// Knuth's estimator: walk random root-to-leaf paths under the current bound.
+// The product of the branching factors seen down to a level is an unbiased
+// estimate of the number of nodes at that level; averaging over probes
+// gives the shape of the whole tree. Probes that reach a leaf may also
+// tighten the incumbent.
+void estimate_search_tree(const int num_probes, TreeEstimate *__restrict__ est){
+
+    memset(est, 0, sizeof(TreeEstimate));
+    if (num_reads == 0) return;
+    unsigned long long verifications = 0ULL;
+    clock_t start = clock();
+
+    for (int p = 0; p < num_probes; p++) {
+        char current[MAX_LEN * MAX_READS];
+        int used[MAX_READS] = {0};
+        int r = probe_rand() % num_reads;
+        double weight = num_reads;
+
+        strcpy(current, reads[r]);
+        used[r] = 1;
+        est->nodes_per_level[1] += weight;
+
+        for (int level = 1; level < num_reads; level++) {
+            int children[MAX_READS], child_ov[MAX_READS];
+            int num_children = 0;
+
+            for (int i = 0; i < num_reads; i++) {
+                if (!used[i]) {
+                    ++verifications;
+                    int ov = overlap(current, reads[i]);
+                    if ((int)(strlen(current) + strlen(reads[i])) - ov < best_len) {
+                        children[num_children] = i;
+                        child_ov[num_children] = ov;
+                        ++num_children;
+                    }
+                }
+            }
+            if (num_children == 0) break;
+
+            int pick = probe_rand() % num_children;
+            used[children[pick]] = 1;
+            strcat(current, reads[children[pick]] + child_ov[pick]);
+            weight *= num_children;
+            est->nodes_per_level[level + 1] += weight;
+
+            if (level + 1 == num_reads && (int)strlen(current) < best_len) {
+                best_len = strlen(current);
+                strcpy(best_result, current);
+            }
+        }
+    }
+
+    for (int level = 1; level <= num_reads; level++) {
+        est->nodes_per_level[level] /= num_probes;
+        est->total_nodes += est->nodes_per_level[level];
+        // every internal node checks each unused read once
+        if (level < num_reads)
+            est->total_overlap_verifications += est->nodes_per_level[level] * (num_reads - level);
+    }
+    est->seconds_per_verification = verifications ?
+        (double)(clock() - start) / CLOCKS_PER_SEC / verifications : 0.0;
+}
+
+
+// Smallest depth that yields TASKS_PER_WORKER subproblems per worker,
+// without going past what fits in the pool
+int choose_cutoff_level(const TreeEstimate *__restrict__ est, const int num_workers){
+
+    const double target = (double)num_workers * TASKS_PER_WORKER;
+    int cutoff_level = 1;
+
+    for (int level = 1; level < num_reads; level++) {
+        if (est->nodes_per_level[level] > POOL_SIZE / 2) break;
+        cutoff_level = level;
+        if (est->nodes_per_level[level] >= target) break;
+    }
+    return cutoff_level;
+}
+
+
+void report_tree_estimate(const TreeEstimate *__restrict__ est, const int cutoff_level, const int num_workers){
+
+    double above = 0.0, below = 0.0;
+    for (int level = 1; level <= num_reads; level++) {
+        if (level <= cutoff_level) above += est->nodes_per_level[level];
+        else below += est->nodes_per_level[level];
+    }
+    double eta = est->total_overlap_verifications * est->seconds_per_verification;
+    double per_subtree = est->nodes_per_level[cutoff_level] > 0.0 ?
+        below / est->nodes_per_level[cutoff_level] : 0.0;
+
+    printf("\nEstimated nodes: %.3e (%.3e up to cutoff, %.3e per subtree)", est->total_nodes, above, per_subtree);
+    printf("\nEstimated subproblems: %.0f for %d workers", est->nodes_per_level[cutoff_level], num_workers);
+    printf("\nEstimated time: %.1fs serial, %.1fs on %d workers\n", eta, eta / num_workers, num_workers);
+}
+
+
 void generate_initial_load_get_subproblems(char *__restrict__ current,  
-    int *__restrict__ used, const int level, 
+    int *__restrict__ used, unsigned char *__restrict__ prefix, const int level, 
     const int cutoff_level, const int curr_len, 
     Subproblems *__restrict__ pool_subproblems) {
     
+    if (pool_overflow) return;
+
     if (level == cutoff_level) {
-       
-        memcpy(pool_subproblems[num_subproblems].current,current,sizeof(char)*curr_len);
+
+        if (num_subproblems == POOL_SIZE) {
+            pool_overflow = 1;
+            return;
+        }
+        memcpy(pool_subproblems[num_subproblems].current,current,sizeof(char)*(curr_len + 1));
         memcpy(pool_subproblems[num_subproblems].used,used,sizeof(int)*MAX_READS);
+        memcpy(pool_subproblems[num_subproblems].prefix,prefix,sizeof(unsigned char)*level);
         ++num_subproblems;
         return;
     }
@@ -67,7 +292,8 @@ void generate_initial_load_get_subproblems(char *__restrict__ current,
 
             // Prune: if current length is already worse than best
             if ((int)strlen(temp) < best_len) {
-                generate_initial_load_get_subproblems(temp, used, level + 1, cutoff_level, strlen(temp),pool_subproblems);
+                prefix[level] = i;
+                generate_initial_load_get_subproblems(temp, used, prefix, level + 1, cutoff_level, strlen(temp),pool_subproblems);
             }
 
             used[i] = 0;
@@ -77,14 +303,26 @@ void generate_initial_load_get_subproblems(char *__restrict__ current,
 
 
 
-void solve_build_superstring(char *__restrict__ current, int *__restrict__ used, const int level, const int curr_len) {
-    
-    if (level == num_reads) {
-        ++num_solutions;
+// Improvements are rare, so only then are the node copies written
+void update_incumbent(const char *__restrict__ current, const int curr_len) {
+    #pragma omp critical(incumbent)
+    {
         if (curr_len < best_len) {
             best_len = curr_len;
             strcpy(best_result, current);
+            for (int k = 0; k < num_active_nodes; k++)
+                node_state[k]->best_len = curr_len;
         }
+    }
+}
+
+
+void solve_build_superstring(SearchContext *__restrict__ ctx, char *__restrict__ current, int *__restrict__ used, const int level, const int curr_len) {
+    
+    if (level == num_reads) {
+        ++ctx->num_solutions;
+        if (curr_len < *ctx->best_len)
+            update_incumbent(current, curr_len);
         return;
     }
 
@@ -93,15 +331,20 @@ void solve_build_superstring(char *__restrict__ current, int *__restrict__ used,
             used[i] = 1;
 
             char temp[MAX_LEN * MAX_READS];
-            ++num_overlap_verifications;
-            int ov = overlap(current, reads[i]);
+            ++ctx->num_overlap_verifications;
+            // Long subproblems must not hold checkpoints back
+            if (--ctx->until_poll == 0) {
+                ctx->until_poll = CHECKPOINT_POLL;
+                maybe_checkpoint();
+            }
+            int ov = overlap(current, ctx->reads[i]);
 
             strcpy(temp, current);
-            strcat(temp, reads[i] + ov);
+            strcat(temp, ctx->reads[i] + ov);
 
             // Prune: if current length is already worse than best
-            if ((int)strlen(temp) < best_len) {
-                solve_build_superstring(temp, used, level + 1, strlen(temp));
+            if ((int)strlen(temp) < *ctx->best_len) {
+                solve_build_superstring(ctx, temp, used, level + 1, strlen(temp));
             }
 
             used[i] = 0;
@@ -109,13 +352,251 @@ void solve_build_superstring(char *__restrict__ current, int *__restrict__ used,
     }
 }
 
+unsigned int hash_reads(){
+    unsigned int h = 2166136261u;  // FNV-1a
+    for (int r = 0; r < num_reads; r++) {
+        for (const char *c = reads[r]; ; c++) {
+            h = (h ^ (unsigned char)*c) * 16777619u;
+            if (!*c) break;
+        }
+    }
+    return h;
+}
+
+
+// A failed write is reported and the next attempt is put off twice as long,
+// so an unwritable directory does not print after every subproblem
+void checkpoint_failed(const char *__restrict__ path){
+    const char *reason = errno ? strerror(errno) : "short write";
+    last_checkpoint = time(NULL);
+    checkpoint_delay = checkpoint_delay > 0 ? 2 * checkpoint_delay : 1;
+    fprintf(stderr, "checkpoint: cannot write %s: %s, retrying in %ds\n", path, reason, checkpoint_delay);
+}
+
+
+// Writes the subproblems not yet finished (done may be NULL), the incumbent
+// and the counters. Subproblems in flight are saved as open and solved again
+// from scratch on resume. Workers flush their counters and mark a subproblem
+// done together under critical(checkpoint), which the caller holds, so the
+// saved totals leave out exactly the subproblems saved as open.
+// Goes through a temporary file so a kill mid-write keeps the previous checkpoint.
+void write_checkpoint(const Subproblems *__restrict__ pool_of_subproblems,
+    const unsigned int num_subproblems, const unsigned char *__restrict__ done, const int cutoff_level){
+
+    char tmp_path[4096];
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", checkpoint_path);
+
+    errno = 0;
+    FILE *fp = fopen(tmp_path, "wb");
+    if (!fp) {
+        checkpoint_failed(tmp_path);
+        return;
+    }
+
+    char incumbent[MAX_SUPERSTRING_LEN];
+    int incumbent_len;
+    #pragma omp critical(incumbent)
+    {
+        incumbent_len = best_len;
+        strcpy(incumbent, best_result);
+    }
+
+    unsigned char *is_open = (unsigned char*)malloc(num_subproblems + 1);
+    unsigned int num_open = 0;
+    for (unsigned int sub = 0; sub < num_subproblems; ++sub) {
+        is_open[sub] = !(done && done[sub]);
+        num_open += is_open[sub];
+    }
+
+    CheckpointHeader header = {CHECKPOINT_MAGIC, CHECKPOINT_VERSION, (unsigned int)num_reads, hash_reads(),
+        cutoff_level, incumbent_len, (unsigned int)strlen(incumbent), num_open,
+        num_solutions, num_overlap_verifications};
+    int ok = fwrite(&header, sizeof(header), 1, fp) == 1 &&
+             fwrite(incumbent, 1, header.best_result_len, fp) == header.best_result_len;
+
+    for (unsigned int sub = 0; ok && sub < num_subproblems; ++sub) {
+        if (!is_open[sub]) continue;
+        unsigned int mask = 0;
+        for (int i = 0; i < num_reads; i++)
+            if (pool_of_subproblems[sub].used[i]) mask |= 1u << i;
+        ok = fwrite(&mask, sizeof(mask), 1, fp) == 1 &&
+             fwrite(pool_of_subproblems[sub].prefix, 1, cutoff_level, fp) == (size_t)cutoff_level;
+    }
+    free(is_open);
+
+    // Only a complete file may replace the previous checkpoint
+    ok = fflush(fp) == 0 && !ferror(fp) && ok;
+    if (fclose(fp) != 0 || !ok || rename(tmp_path, checkpoint_path) != 0) {
+        checkpoint_failed(tmp_path);
+        remove(tmp_path);
+        return;
+    }
+    last_checkpoint = time(NULL);
+    checkpoint_delay = checkpoint_interval;
+}
+
+
+// Restores the frontier written by write_checkpoint. Returns the pool of open
+// subproblems, or NULL if the file is missing or belongs to another instance.
+Subproblems* read_checkpoint(int *__restrict__ cutoff_level){
+
+    FILE *fp = fopen(checkpoint_path, "rb");
+    if (!fp) {
+        perror("resume");
+        return NULL;
+    }
+
+    CheckpointHeader header;
+    if (fread(&header, sizeof(header), 1, fp) != 1 || header.magic != CHECKPOINT_MAGIC ||
+        header.version != CHECKPOINT_VERSION || header.num_reads != (unsigned int)num_reads ||
+        header.reads_hash != hash_reads() || header.num_subproblems > POOL_SIZE ||
+        header.best_result_len >= sizeof(best_result) ||
+        header.cutoff_level < 1 || header.cutoff_level > num_reads) {
+        fprintf(stderr, "resume: %s is not a checkpoint of this instance\n", checkpoint_path);
+        fclose(fp);
+        return NULL;
+    }
+
+    *cutoff_level = header.cutoff_level;
+    best_len = header.best_len;
+    num_subproblems = header.num_subproblems;
+    num_solutions = header.num_solutions;
+    num_overlap_verifications = header.num_overlap_verifications;
+
+    int ok = fread(best_result, 1, header.best_result_len, fp) == header.best_result_len;
+    best_result[header.best_result_len] = '\0';
+
+    Subproblems *pool_of_subproblems = (Subproblems*)malloc(POOL_SIZE * sizeof(Subproblems));
+    for (unsigned int sub = 0; ok && sub < num_subproblems; ++sub) {
+        Subproblems *sp = &pool_of_subproblems[sub];
+        unsigned int mask;
+        ok = fread(&mask, sizeof(mask), 1, fp) == 1 &&
+             fread(sp->prefix, 1, header.cutoff_level, fp) == (size_t)header.cutoff_level;
+
+        for (int i = 0; ok && i < num_reads; i++)
+            sp->used[i] = (mask >> i) & 1u;
+
+        // The string is not stored, it is spelled again from the prefix
+        for (int k = 0; ok && k < header.cutoff_level; k++) {
+            ok = sp->prefix[k] < num_reads;
+            if (!ok) break;
+            if (k == 0) strcpy(sp->current, reads[sp->prefix[0]]);
+            else strcat(sp->current, reads[sp->prefix[k]] + overlap(sp->current, reads[sp->prefix[k]]));
+        }
+    }
+    fclose(fp);
+
+    if (!ok) {
+        fprintf(stderr, "resume: %s is truncated\n", checkpoint_path);
+        free(pool_of_subproblems);
+        return NULL;
+    }
+    return pool_of_subproblems;
+}
+
+
+void maybe_checkpoint(){
+    if (checkpoint_path && checkpoint_pool && time(NULL) - last_checkpoint >= checkpoint_delay) {
+        #pragma omp critical(checkpoint)
+        if (time(NULL) - last_checkpoint >= checkpoint_delay)
+            write_checkpoint(checkpoint_pool, checkpoint_pool_size, checkpoint_done, checkpoint_cutoff);
+    }
+}
+
+
+// Own node first; other nodes' slices are only raided once it is drained
+int next_subproblem(const int home){
+    for (int d = 0; d < num_active_nodes; d++) {
+        NodeState *ns = node_state[(home + d) % num_active_nodes];
+        if (ns->next >= ns->end) continue;   // plain read first, no atomic on a drained queue
+        unsigned int sub;
+        #pragma omp atomic capture
+        sub = ns->next++;
+        if (sub < ns->end) return sub;
+    }
+    return -1;
+}
+
+
 void solve_launch_parallel_search(Subproblems *__restrict__ pool_of_subproblems, 
-    const unsigned int num_subproblems, const int cutoff_level){
+    const unsigned int num_subproblems, const int cutoff_level, const int num_workers){
+
+    last_checkpoint = time(NULL);
+    checkpoint_delay = checkpoint_interval;
+    unsigned char *done = (unsigned char*)calloc(num_subproblems + 1, 1);
+    checkpoint_pool = pool_of_subproblems;
+    checkpoint_pool_size = num_subproblems;
+    checkpoint_done = done;
+    checkpoint_cutoff = cutoff_level;
+
+    #pragma omp parallel num_threads(num_workers)
+    {
+        const int num_threads = omp_get_num_threads();
+        const int thread = omp_get_thread_num();
+
+        // The runtime may hand out fewer threads than asked for, so the
+        // node count follows the team actually running
+        #pragma omp single
+        {
+            num_active_nodes = numa_active_nodes(&topology, num_threads);
+            printf("\nWorkers: %d on %d NUMA node(s)\n", num_threads, num_active_nodes);
+        }
 
-    for(int sub = 0; sub<num_subproblems; ++sub){
-        solve_build_superstring( pool_of_subproblems[sub].current, pool_of_subproblems[sub].used, cutoff_level, strlen(pool_of_subproblems[sub].current));
+        const int node = numa_thread_node(&topology, thread, num_threads);
+        numa_pin_thread(&topology, node, numa_thread_rank(&topology, thread, num_threads));
+
+        // The node leader builds the replica after pinning, so first touch
+        // places it in that node's memory
+        if (numa_thread_rank(&topology, thread, num_threads) == 0) {
+            NodeState *ns = (NodeState*)aligned_alloc(CACHE_LINE, sizeof(NodeState));
+            memset(ns, 0, sizeof(NodeState));
+            ns->reads = (char (*)[MAX_LEN])malloc(num_reads * MAX_LEN);
+            memcpy(ns->reads, reads, num_reads * MAX_LEN);
+            // Each node's slice of the queue matches its share of the threads
+            ns->begin = ns->next = (unsigned long long)num_subproblems *
+                numa_node_first_thread(&topology, node, num_threads) / num_threads;
+            ns->end = (unsigned long long)num_subproblems *
+                numa_node_first_thread(&topology, node + 1, num_threads) / num_threads;
+            ns->best_len = best_len;
+            node_state[node] = ns;
+        }
+        #pragma omp barrier
+
+        SearchContext ctx = {node_state[node]->reads, &node_state[node]->best_len, 0ULL, 0ULL, CHECKPOINT_POLL};
+        char current[MAX_SUPERSTRING_LEN];
+        int used[MAX_READS];
+        int sub;
+
+        while ((sub = next_subproblem(node)) >= 0) {
+            // Work on a private copy, the pool lives in the master's memory
+            strcpy(current, pool_of_subproblems[sub].current);
+            memcpy(used, pool_of_subproblems[sub].used, sizeof(used));
+            ctx.num_solutions = ctx.num_overlap_verifications = 0ULL;
+
+            if ((int)strlen(current) < *ctx.best_len)
+                solve_build_superstring(&ctx, current, used, cutoff_level, strlen(current));
+
+            // Counters and the done flag change together, see write_checkpoint
+            #pragma omp critical(checkpoint)
+            {
+                num_solutions += ctx.num_solutions;
+                num_overlap_verifications += ctx.num_overlap_verifications;
+                done[sub] = 1;
+            }
+
+            maybe_checkpoint();
+        }
+
+        #pragma omp barrier
+        if (numa_thread_rank(&topology, thread, num_threads) == 0) {
+            free(node_state[node]->reads);
+            free(node_state[node]);
+        }
     }
 
+    checkpoint_pool = NULL;
+    checkpoint_done = NULL;
+    free(done);
 }
 
 
@@ -124,13 +605,23 @@ Subproblems* generate_initial_load_start_pool(const int cutoff_level){
     Subproblems *pool_of_subproblems = (Subproblems*)malloc(POOL_SIZE * sizeof(Subproblems));
     char initial[MAX_LEN * MAX_READS] = "";
     int used[MAX_READS] = {0};
+    unsigned char prefix[MAX_READS] = {0};
     
     for (int i = 0; i < num_reads; i++) {
         used[i] = 1;
+        prefix[0] = i;
         strcpy(initial, reads[i]);
-        generate_initial_load_get_subproblems(initial, used, 1, cutoff_level, strlen(initial),pool_of_subproblems);
+        generate_initial_load_get_subproblems(initial, used, prefix, 1, cutoff_level, strlen(initial),pool_of_subproblems);
         used[i] = 0;
     }
+
+    // More than POOL_SIZE subproblems at this depth: the caller decides
+    if (pool_overflow) {
+        free(pool_of_subproblems);
+        pool_overflow = 0;
+        num_subproblems = 0;
+        return NULL;
+    }
     return pool_of_subproblems;
 }
 
@@ -138,15 +629,38 @@ Subproblems* generate_initial_load_start_pool(const int cutoff_level){
 
 int main(int argc, char *argv[]) {
 
-    if (argc != 3) {
-        fprintf(stderr, "Usage: %s reads.txt\n cutoff_level", argv[0]);
+    // Options may appear anywhere; the rest are positional
+    char *args[3];
+    int num_args = 0, resume = 0;
+    for (int a = 1; a < argc; a++) {
+        if (strcmp(argv[a], "--resume") == 0) resume = 1;
+        else if (strncmp(argv[a], "--checkpoint=", 13) == 0) checkpoint_path = argv[a] + 13;
+        else if (strncmp(argv[a], "--checkpoint-interval=", 22) == 0) checkpoint_interval = atoi(argv[a] + 22);
+        else if (num_args < 3) args[num_args++] = argv[a];
+        else num_args = 4;
+    }
+
+    if (num_args < 1 || num_args > 3) {
+        fprintf(stderr, "Usage: %s reads.txt [cutoff_level|auto] [num_workers] "
+            "[--checkpoint=file] [--checkpoint-interval=seconds] [--resume]\n", argv[0]);
         return 1;
     }
 
-    int cutoff_level = atoi(argv[2]);
+    int auto_cutoff = num_args < 2 || strcmp(args[1], "auto") == 0;
+    int cutoff_level = auto_cutoff ? 0 : atoi(args[1]);
+    // By default one worker per CPU this process may run on
+    numa_topology_detect(&topology);
+    int num_workers = num_args == 3 ? atoi(args[2]) : numa_total_cpus(&topology);
+    if (num_workers < 1) num_workers = 1;
+
+    char default_checkpoint[4096];
+    if (!checkpoint_path) {
+        snprintf(default_checkpoint, sizeof(default_checkpoint), "%s.ckpt", args[0]);
+        checkpoint_path = default_checkpoint;
+    }
 
 
-    FILE *fp = fopen(argv[1], "r");
+    FILE *fp = fopen(args[0], "r");
     if (!fp) {
         perror("fopen");
         return 1;
@@ -163,19 +677,53 @@ int main(int argc, char *argv[]) {
 
     printf("\n############## Problem Read -- OK ##############\n");
     printf("\nNum reads: %d\n", num_reads);
-    
-    
-    Subproblems *pool_of_subproblems = generate_initial_load_start_pool(atoi(argv[2]));
+
+    Subproblems *pool_of_subproblems = NULL;
+
+    if (resume) {
+        pool_of_subproblems = read_checkpoint(&cutoff_level);
+        if (!pool_of_subproblems) return 1;
+        printf("\nResumed from %s, incumbent: %d", checkpoint_path, best_len);
+    }
+    else if (auto_cutoff && num_reads > 0) {
+        TreeEstimate est;
+        seed_incumbent_greedy();
+        estimate_search_tree(NUM_PROBES, &est);
+        cutoff_level = choose_cutoff_level(&est, num_workers);
+        printf("\nInitial bound: %d", best_len);
+        report_tree_estimate(&est, cutoff_level, num_workers);
+    }
+
+    // At least one read placed, at most all of them
+    if (cutoff_level > num_reads) cutoff_level = num_reads;
+    if (cutoff_level < 1) cutoff_level = 1;
+    if (num_reads == 0) best_len = 0;   // the empty superstring
+
+    // The automatic cutoff comes from a sample and may undershoot the real
+    // tree, so an overflowing pool is retried one level shallower
+    while (!pool_of_subproblems) {
+        pool_of_subproblems = generate_initial_load_start_pool(cutoff_level);
+        if (pool_of_subproblems) break;
+        if (!auto_cutoff || cutoff_level <= 1) {
+            fprintf(stderr, "Pool overflow: more than %d subproblems at cutoff depth %d\n", POOL_SIZE, cutoff_level);
+            return 1;
+        }
+        --cutoff_level;
+        printf("\nPool overflow, retrying at cutoff depth %d", cutoff_level);
+    }
 
     printf("\nCutoff depth: %d, Num subproblems: %u", cutoff_level, num_subproblems);
 
-    solve_launch_parallel_search(pool_of_subproblems, num_subproblems,  cutoff_level);
+    solve_launch_parallel_search(pool_of_subproblems, num_subproblems, cutoff_level, num_workers);
 
     printf("\nBest superstring: %s\n", best_result);
     printf("Length: %d\n", best_len);
     printf("Number of stringcomp calls: %llu \n", num_overlap_verifications);
     printf("Number of complete solutions found: %llu \n", num_solutions);
 
+    // The run finished, so whatever was saved is stale now
+    remove(checkpoint_path);
+
     free(pool_of_subproblems);
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,173 @@
+#ifndef SEARCH_KERNEL_H
+#define SEARCH_KERNEL_H
+
+#include <stdint.h>
+#include <string.h>
+#include <limits.h>
+
+#include "expand_kernel.h"
+
+// Exact branch-and-bound over read orderings, specialized at compile
+// time on the read count bucket N and the matching mask type. Rows are
+// fixed size, so the bound check unrolls into BLOCKS kernel calls and
+// the used mask stays in a register.
+//
+// Every read j adds at least lb_cost[j] = len[j] - its best incoming
+// overlap. The search carries bound = length so far + lb_cost of every
+// unused read, and its rows hold cost[i][j] - lb_cost[j], so one step
+// updates bound like a plain cost would and the same SIMD check prunes
+// on it.
+template <int N, typename Mask>
+struct SearchKernel {
+    static constexpr int W = N < EXPAND_BLOCK ? EXPAND_BLOCK : N;
+    static constexpr int BLOCKS = W / EXPAND_BLOCK;
+
+    static_assert(sizeof(Mask) * 8 >= N, "mask too narrow for bucket");
+
+    alignas(64) int cost[N][W];   // len[j] - ov[i][j] - lb_cost[j], never negative
+    int len[N];
+    int lb_cost[N];
+    int lb_total;
+    int n;
+    Mask full;
+    int best_len;               // pruning bound
+    int found_len;              // length of best_order, INT_MAX while none was found
+    int order[N];
+    int best_order[N];
+    unsigned long long num_nodes;
+    const volatile int *stop;   // polled every 1K nodes, nonzero abandons the search
+    int *shared_bound;          // incumbent shared with other searches, read and lowered here
+
+    // len[i] is the length of read i, ov[i * stride + j] the overlap of i followed by j
+    void load(int n_reads, const int *lens, const int *ov, int stride) {
+        n = n_reads;
+        full = n == (int)(sizeof(Mask) * 8) ? (Mask)~(Mask)0 : (Mask)(((Mask)1 << n) - 1);
+        num_nodes = 0;
+        found_len = INT_MAX;
+        stop = nullptr;
+        shared_bound = nullptr;
+        lb_total = 0;
+        for (int j = 0; j < n; j++) {
+            len[j] = lb_cost[j] = lens[j];
+            for (int i = 0; i < n; i++)
+                if (i != j && lens[j] - ov[i * stride + j] < lb_cost[j]) lb_cost[j] = lens[j] - ov[i * stride + j];
+            lb_total += lb_cost[j];
+        }
+        for (int i = 0; i < N; i++) {
+            for (int j = 0; j < W; j++)
+                cost[i][j] = (i < n && j < n) ? lens[j] - ov[i * stride + j] - lb_cost[j] : INT_MAX;
+        }
+    }
+
+    void poll() {
+        // A zero bound prunes everything, so the recursion unwinds on its own
+        if (stop && *stop) {
+            best_len = 0;
+        }
+        else if (shared_bound) {
+            int bound = __atomic_load_n(shared_bound, __ATOMIC_RELAXED);
+            if (bound < best_len) best_len = bound;
+        }
+    }
+
+    void publish(int len) {
+        int bound = __atomic_load_n(shared_bound, __ATOMIC_RELAXED);
+        while (len < bound && !__atomic_compare_exchange_n(shared_bound, &bound, len, true,
+            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {}
+    }
+
+    // With every read used, bound is the exact length
+    void dfs(int last, Mask used, int depth, int bound) {
+        if ((++num_nodes & 0x3FF) == 0)
+            poll();
+        if (used == full) {
+            if (bound < best_len) {
+                best_len = found_len = bound;
+                memcpy(best_order, order, n * sizeof(int));
+                if (shared_bound) publish(bound);
+            }
+            return;
+        }
+
+        Mask avail = (Mask)~used;
+        for (int w = 0; w < BLOCKS; w++) {
+            uint32_t children = expand_children32(cost[last] + w * EXPAND_BLOCK,
+                (uint32_t)(avail >> (w * EXPAND_BLOCK)), best_len - bound);
+
+            while (children) {
+                int i = w * EXPAND_BLOCK + __builtin_ctz(children);
+                children &= children - 1;
+
+                int new_bound = bound + cost[last][i];
+                if (new_bound >= best_len) continue; // best_len may have tightened meanwhile
+
+                order[depth] = i;
+                dfs(i, used | ((Mask)1 << i), depth + 1, new_bound);
+            }
+        }
+    }
+
+    // root < 0 searches every first read, otherwise only the subtree below root
+    void solve(const int root = -1) {
+        for (int i = 0; i < n; i++) {
+            // the first read adds its whole length instead of lb_cost
+            int bound = lb_total - lb_cost[i] + len[i];
+            if ((root >= 0 && i != root) || bound >= best_len) continue;
+            order[0] = i;
+            dfs(i, (Mask)1 << i, 1, bound);
+        }
+    }
+};
+
+// Largest read count the specialized kernels handle
+#define SEARCH_KERNEL_MAX_READS 128
+
+template <int N, typename Mask>
+int run_search_kernel(int n, const int *lens, const int *ov, int stride,
+    int bound, int *order, unsigned long long *num_nodes, int root = -1,
+    const volatile int *stop = nullptr, int *shared_bound = nullptr) {
+
+    SearchKernel<N, Mask> *k = new SearchKernel<N, Mask>;
+    k->load(n, lens, ov, stride);
+    k->best_len = bound;
+    k->stop = stop;
+    k->shared_bound = shared_bound;
+    k->poll();
+    k->solve(root);
+
+    // A stopped search still hands back the best ordering it reached
+    int best = k->found_len < bound ? k->found_len : bound;
+    if (k->found_len < bound)
+        memcpy(order, k->best_order, n * sizeof(int));
+    if (num_nodes)
+        *num_nodes += k->num_nodes;
+
+    delete k;
+    return best;
+}
+
+// Runtime dispatch to the smallest bucket that fits n.
+// order holds the incumbent ordering of length bound on entry and the
+// best ordering found on return. With root >= 0 only orderings starting
+// with that read are searched, so a solve can be split across tasks.
+// Setting *stop abandons the search with the best ordering so far.
+// Searches running side by side can share *shared_bound: each one prunes
+// with it and lowers it when it finds something shorter. Nothing at or
+// above it is returned, so the caller keeps its own ordering then.
+// Returns the optimal length, or -1 if n exceeds SEARCH_KERNEL_MAX_READS.
+static inline int solve_exact(int n, const int *lens, const int *ov, int stride,
+    int bound, int *order, unsigned long long *num_nodes = nullptr, int root = -1,
+    const volatile int *stop = nullptr, int *shared_bound = nullptr) {
+
+    if (n <= 16)
+        return run_search_kernel<16, uint16_t>(n, lens, ov, stride, bound, order, num_nodes, root, stop, shared_bound);
+    if (n <= 32)
+        return run_search_kernel<32, uint32_t>(n, lens, ov, stride, bound, order, num_nodes, root, stop, shared_bound);
+    if (n <= 64)
+        return run_search_kernel<64, uint64_t>(n, lens, ov, stride, bound, order, num_nodes, root, stop, shared_bound);
+    if (n <= SEARCH_KERNEL_MAX_READS)
+        return run_search_kernel<128, __uint128_t>(n, lens, ov, stride, bound, order, num_nodes, root, stop, shared_bound);
+    return -1;
+}
+
+#endif
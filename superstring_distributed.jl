@@ -32,12 +32,13 @@ function julia_main(args::Vector{String})::Cint
     
     ### parameters checking
     if length(args) != 3
-        @error "Usage: julia <script_name>.jl reads.txt cutoff_level num_workers"
+        @error "Usage: julia <script_name>.jl reads.txt cutoff_level|auto num_workers"
         return 1
     end
 
     filename = args[1]
-    cutoff_level = parse(Int, args[2]) 
+    auto_cutoff = args[2] == "auto"
+    cutoff_level = auto_cutoff ? 0 : parse(Int, args[2])
     num_workers_requested = parse(Int, args[3]) # Parse num_workers from command line
 
     # Master uses the common SuperstringWorkerLogic.SolverState
@@ -61,6 +62,25 @@ function julia_main(args::Vector{String})::Cint
     println("\n############## Problem Read -- OK ##############")
     println("\nNum reads: $(master_solver_state.num_reads)")
 
+    # Pick the cutoff from a sampled estimate of the search tree instead of by hand
+    if auto_cutoff && master_solver_state.num_reads > 0
+        SuperstringWorkerLogic.seed_incumbent_greedy!(master_solver_state)
+        nodes_per_level, total_verifications, seconds_per_verification =
+            SuperstringWorkerLogic.estimate_search_tree(master_solver_state, SuperstringWorkerLogic.NUM_PROBES)
+        cutoff_level = SuperstringWorkerLogic.choose_cutoff_level(nodes_per_level, num_workers_requested)
+
+        eta = total_verifications * seconds_per_verification
+        above = sum(nodes_per_level[1:cutoff_level])
+        below = sum(nodes_per_level[cutoff_level+1:end]; init = 0.0)
+        println("\nInitial bound: $(master_solver_state.best_len)")
+        @printf("Estimated nodes: %.3e (%.3e up to cutoff, %.3e per subtree)\n",
+            above + below, above, nodes_per_level[cutoff_level] > 0 ? below / nodes_per_level[cutoff_level] : 0.0)
+        @printf("Estimated subproblems: %.0f for %d workers\n", nodes_per_level[cutoff_level], num_workers_requested)
+        @printf("Estimated time: %.1fs serial, %.1fs on %d workers\n", eta, eta / num_workers_requested, num_workers_requested)
+    end
+    # At least one read placed, at most all of them
+    cutoff_level = clamp(cutoff_level, 1, max(master_solver_state.num_reads, 1))
+
 
     
     # Load generation (on master)
@@ -158,8 +178,11 @@ function julia_main(args::Vector{String})::Cint
         #### [2] - one optimal solution (There might be planty of optimal solutions)
         #### [3] - number of complete solutions found by the distributed search
         #### [4] - the number of string overlap operations performed -- the most expensive one    
-        master_current_best_len = aggregated_results[1] 
-        master_current_best_result = aggregated_results[2]
+        # Workers that cannot beat the seeded bound return it with an empty string
+        if aggregated_results[1] < master_current_best_len
+            master_current_best_len = aggregated_results[1]
+            master_current_best_result = aggregated_results[2]
+        end
         master_total_solutions_count += aggregated_results[3] 
         master_total_overlap_verifications_count += aggregated_results[4] 
 
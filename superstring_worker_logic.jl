@@ -7,6 +7,8 @@ using Distributed
 const MAX_READS = 20
 const MAX_LEN = 100
 const POOL_SIZE = 10000
+const NUM_PROBES = 2000
+const TASKS_PER_WORKER = 16
 const MAX_SUPERSTRING_LEN = MAX_READS * MAX_LEN 
 
 # This single struct will used by both master and workers
@@ -50,6 +52,103 @@ function overlap(a::AbstractString, b::AbstractString)::Int
     return 0
 end
 
+# Nearest-neighbour superstring from every starting read; the shortest one
+# becomes the incumbent so the estimator and the search start with a finite bound
+function seed_incumbent_greedy!(solver_state_obj::SolverState)
+    n = solver_state_obj.num_reads
+    for start in 1:n
+        used = fill(false, n)
+        used[start] = true
+        current = solver_state_obj.reads[start]
+
+        for _ in 2:n
+            next, best_ov = 0, -1
+            for i in 1:n
+                if !used[i]
+                    ov = overlap(current, solver_state_obj.reads[i])
+                    if ov > best_ov
+                        next, best_ov = i, ov
+                    end
+                end
+            end
+            used[next] = true
+            current = current * solver_state_obj.reads[next][best_ov+1:end]
+        end
+
+        if length(current) < solver_state_obj.best_len
+            solver_state_obj.best_len = UInt64(length(current))
+            solver_state_obj.best_result = current
+        end
+    end
+end
+
+# Knuth's estimator: random root-to-leaf probes under the current bound.
+# The product of branching factors down to a level estimates the number of
+# nodes at that level. Returns (nodes_per_level, overlap_verifications, seconds_per_verification),
+# where nodes_per_level[l] counts nodes with l reads placed.
+function estimate_search_tree(solver_state_obj::SolverState, num_probes::Int)
+    n = solver_state_obj.num_reads
+    nodes_per_level = zeros(Float64, n)
+    n == 0 && return nodes_per_level, 0.0, 0.0
+    verifications = 0
+    start_time = time()
+
+    for _ in 1:num_probes
+        used = fill(false, n)
+        r = rand(1:n)
+        used[r] = true
+        current = solver_state_obj.reads[r]
+        weight = Float64(n)
+        nodes_per_level[1] += weight
+
+        for level in 1:n-1
+            children = Int[]
+            child_ov = Int[]
+            for i in 1:n
+                if !used[i]
+                    verifications += 1
+                    ov = overlap(current, solver_state_obj.reads[i])
+                    if length(current) + length(solver_state_obj.reads[i]) - ov < solver_state_obj.best_len
+                        push!(children, i)
+                        push!(child_ov, ov)
+                    end
+                end
+            end
+            isempty(children) && break
+
+            pick = rand(1:length(children))
+            used[children[pick]] = true
+            current = current * solver_state_obj.reads[children[pick]][child_ov[pick]+1:end]
+            weight *= length(children)
+            nodes_per_level[level + 1] += weight
+
+            if level + 1 == n && length(current) < solver_state_obj.best_len
+                solver_state_obj.best_len = UInt64(length(current))
+                solver_state_obj.best_result = current
+            end
+        end
+    end
+
+    nodes_per_level ./= num_probes
+    # every internal node checks each unused read once
+    total_verifications = sum(nodes_per_level[l] * (n - l) for l in 1:n-1; init = 0.0)
+    seconds_per_verification = verifications > 0 ? (time() - start_time) / verifications : 0.0
+    return nodes_per_level, total_verifications, seconds_per_verification
+end
+
+# Smallest depth that yields TASKS_PER_WORKER subproblems per worker,
+# without going past what fits in the pool
+function choose_cutoff_level(nodes_per_level::Vector{Float64}, num_workers::Int)::Int
+    target = num_workers * TASKS_PER_WORKER
+    cutoff_level = 1
+    for level in 1:length(nodes_per_level)-1
+        nodes_per_level[level] > POOL_SIZE / 2 && break
+        cutoff_level = level
+        nodes_per_level[level] >= target && break
+    end
+    return cutoff_level
+end
+
 # This function (primarily for initial load generation on master) now takes a common SolverState type
 function generate_initial_load_get_subproblems(
     solver_state_obj::SolverState, # Takes a SolverState object
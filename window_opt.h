@@ -0,0 +1,139 @@
+#ifndef WINDOW_OPT_H
+#define WINDOW_OPT_H
+
+#include <stdint.h>
+#include <limits.h>
+
+#include "overlap_matrix.h"
+
+// Largest window the bitmask DP accepts: 2^16 * 16 states
+#define WINDOW_MAX 16
+
+
+// Cost of appending b after a; a < 0 means b starts the superstring
+static inline int window_step(const ReadSet *__restrict__ rs, const int a, const int b) {
+    return rs->len[b] - (a < 0 ? 0 : rs->overlap[(size_t)a * rs->n + b]);
+}
+
+
+// Exact reordering of the k reads in window with the reads before and after
+// it kept in place (pre/post < 0 at the ends of the ordering). Held-Karp
+// bitmask DP over the window. Rewrites window and returns the gain.
+static inline int window_solve(const ReadSet *__restrict__ rs, int *__restrict__ window, const int k,
+    const int pre, const int post) {
+
+    const int full = (1 << k) - 1;
+    int *dp = (int *)malloc((size_t)(full + 1) * k * sizeof(int));
+    unsigned char *from = (unsigned char *)malloc((size_t)(full + 1) * k);
+
+    for (int i = 0; i < (full + 1) * k; i++)
+        dp[i] = INT_MAX;
+    for (int j = 0; j < k; j++)
+        dp[(1 << j) * k + j] = window_step(rs, pre, window[j]);
+
+    for (int mask = 1; mask <= full; mask++) {
+        for (int j = 0; j < k; j++) {
+            int cur = dp[mask * k + j];
+            if (cur == INT_MAX) continue;
+            int rest = full & ~mask;
+            while (rest) {
+                int t = __builtin_ctz(rest);
+                rest &= rest - 1;
+                int next = (mask | (1 << t)) * k + t;
+                int cand = cur + window_step(rs, window[j], window[t]);
+                if (cand < dp[next]) {
+                    dp[next] = cand;
+                    from[next] = j;
+                }
+            }
+        }
+    }
+
+    int old_cost = window_step(rs, pre, window[0]);
+    for (int j = 1; j < k; j++)
+        old_cost += window_step(rs, window[j - 1], window[j]);
+    if (post >= 0) old_cost += window_step(rs, window[k - 1], post);
+
+    int best_last = 0, best_cost = INT_MAX;
+    for (int j = 0; j < k; j++) {
+        int cost = dp[full * k + j] + (post >= 0 ? window_step(rs, window[j], post) : 0);
+        if (cost < best_cost) {
+            best_cost = cost;
+            best_last = j;
+        }
+    }
+
+    int gain = old_cost - best_cost;
+    if (gain > 0) {
+        int reordered[WINDOW_MAX];
+        for (int pos = k - 1, mask = full, j = best_last; pos >= 0; pos--) {
+            reordered[pos] = window[j];
+            int prev = from[mask * k + j];
+            mask &= ~(1 << j);
+            j = prev;
+        }
+        memcpy(window, reordered, k * sizeof(int));
+    }
+
+    free(dp);
+    free(from);
+    return gain > 0 ? gain : 0;
+}
+
+
+// Window of the sweep starting at begin, clipped at the end of the ordering.
+// Skipped once *stop is set, which leaves the ordering as it is.
+static inline int window_sweep_step(const ReadSet *__restrict__ rs, int *__restrict__ order, const int k, const int begin,
+    const volatile int *stop) {
+    const int n = rs->n;
+    int size = begin + k <= n ? k : n - begin;
+    if (size < 2 || (stop && *stop)) return 0;
+    return window_solve(rs, order + begin, size,
+        begin > 0 ? order[begin - 1] : -1,
+        begin + size < n ? order[begin + size] : -1);
+}
+
+
+// Large-neighbourhood improvement of any ordering: every window of k
+// consecutive reads is re-solved exactly with its neighbours fixed. Windows
+// in a sweep are separated by one fixed read so they run in parallel; the
+// sweep is repeated at a half-window shift and until nothing improves, or
+// until *stop is set. Returns the new superstring length.
+static inline int window_optimize(const ReadSet *__restrict__ rs, int *__restrict__ order, int k,
+    int *__restrict__ num_passes, const volatile int *stop = nullptr) {
+
+    const int n = rs->n;
+    if (k > WINDOW_MAX) k = WINDOW_MAX;
+    if (k > n) k = n;
+
+    int passes = 0;
+    if (k >= 2) {
+        const int shifts[2] = {0, (k + 1) / 2};
+        int improved = 1;
+        while (improved && !(stop && *stop)) {
+            improved = 0;
+            ++passes;
+            for (int sh = 0; sh < 2 && !(stop && *stop); sh++) {
+                int gain = 0;
+                int num_windows = (n - shifts[sh] + k) / (k + 1);
+
+                if (in_parallel_region()) {
+                    #pragma omp taskloop grainsize(1) reduction(+:gain)
+                    for (int w = 0; w < num_windows; w++)
+                        gain += window_sweep_step(rs, order, k, shifts[sh] + w * (k + 1), stop);
+                }
+                else {
+                    #pragma omp parallel for schedule(dynamic) reduction(+:gain)
+                    for (int w = 0; w < num_windows; w++)
+                        gain += window_sweep_step(rs, order, k, shifts[sh] + w * (k + 1), stop);
+                }
+                if (gain > 0) improved = 1;
+            }
+        }
+    }
+
+    if (num_passes) *num_passes = passes;
+    return order_length(rs, order);
+}
+
+#endif